@@ -0,0 +1,248 @@
+#ifndef LOO_BENCH_BASELINES_HPP
+#define LOO_BENCH_BASELINES_HPP
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+#include "looqueue/align.hpp"
+
+/**
+ * Comparison baselines for the benchmark harness, all of which share the interface of `loo::queue`
+ * (`enqueue(T*)` and `dequeue()` returning `nullptr` if empty).
+ *
+ * Neither of the lock-free baselines reclaims any memory while the queue is in use, which gives
+ * them a slight edge over `loo::queue`.
+ * Since no node is ever re-used, they can also not suffer from the ABA problem.
+ * All nodes remain linked to each other, so they can be freed once the queue is destroyed.
+ */
+namespace bench {
+/** a std::deque protected by a std::mutex */
+template <typename T>
+class mutex_queue {
+public:
+  using pointer = T*;
+
+  void enqueue(pointer elem) {
+    std::lock_guard guard{ this->m_mutex };
+    this->m_deque.push_back(elem);
+  }
+
+  pointer dequeue() {
+    std::lock_guard guard{ this->m_mutex };
+    if (this->m_deque.empty()) {
+      return nullptr;
+    }
+
+    const auto res = this->m_deque.front();
+    this->m_deque.pop_front();
+    return res;
+  }
+
+private:
+  std::mutex         m_mutex;
+  std::deque<T*>     m_deque;
+};
+
+/** the lock-free queue by Michael & Scott (1996) */
+template <typename T>
+class ms_queue {
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+
+  struct node_t {
+    T*                   elem{ nullptr };
+    std::atomic<node_t*> next{ nullptr };
+  };
+
+public:
+  using pointer = T*;
+
+  ms_queue() {
+    this->m_first = new node_t();
+    this->m_head.store(this->m_first, relaxed);
+    this->m_tail.store(this->m_first, relaxed);
+  }
+
+  ~ms_queue() noexcept {
+    // dequeued nodes are never unlinked, so all nodes are reachable from the first one
+    auto curr = this->m_first;
+    while (curr != nullptr) {
+      const auto next = curr->next.load(relaxed);
+      delete curr;
+      curr = next;
+    }
+  }
+
+  void enqueue(pointer elem) {
+    const auto node = new node_t{ elem };
+    while (true) {
+      auto tail = this->m_tail.load(acquire);
+      auto next = tail->next.load(acquire);
+      if (tail != this->m_tail.load(relaxed)) {
+        continue;
+      }
+
+      if (next == nullptr) {
+        if (tail->next.compare_exchange_weak(next, node, release, relaxed)) {
+          this->m_tail.compare_exchange_strong(tail, node, release, relaxed);
+          return;
+        }
+      } else {
+        this->m_tail.compare_exchange_weak(tail, next, release, relaxed);
+      }
+    }
+  }
+
+  pointer dequeue() {
+    while (true) {
+      auto head = this->m_head.load(acquire);
+      auto tail = this->m_tail.load(acquire);
+      const auto next = head->next.load(acquire);
+      if (head != this->m_head.load(relaxed)) {
+        continue;
+      }
+
+      if (next == nullptr) {
+        return nullptr;
+      }
+
+      if (head == tail) {
+        this->m_tail.compare_exchange_weak(tail, next, release, relaxed);
+        continue;
+      }
+
+      // the element must be read before the CAS, since another thread may dequeue `next` as soon
+      // as it becomes the new head
+      const auto res = next->elem;
+      if (this->m_head.compare_exchange_weak(head, next, release, relaxed)) {
+        return res;
+      }
+    }
+  }
+
+private:
+  node_t* m_first;
+  alignas(CACHE_LINE_ALIGN) std::atomic<node_t*> m_head;
+  alignas(CACHE_LINE_ALIGN) std::atomic<node_t*> m_tail;
+};
+
+/** the FAA based array queue by Ramalhete & Correia (2016) */
+template <typename T>
+class faa_array_queue {
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+  static constexpr auto acq_rel = std::memory_order_acq_rel;
+
+  static constexpr std::size_t NODE_SIZE = 1024;
+
+  struct node_t {
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> deq_idx{ 0 };
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> enq_idx{ 1 };
+    alignas(CACHE_LINE_ALIGN) std::atomic<node_t*>     next{ nullptr };
+    std::array<std::atomic<T*>, NODE_SIZE>             slots{ };
+
+    explicit node_t(T* first) {
+      for (auto& slot : this->slots) {
+        slot.store(nullptr, relaxed);
+      }
+
+      this->slots[0].store(first, relaxed);
+    }
+  };
+
+public:
+  using pointer = T*;
+
+  faa_array_queue() {
+    this->m_first = new node_t(nullptr);
+    this->m_first->enq_idx.store(0, relaxed);
+    this->m_head.store(this->m_first, relaxed);
+    this->m_tail.store(this->m_first, relaxed);
+  }
+
+  ~faa_array_queue() noexcept {
+    auto curr = this->m_first;
+    while (curr != nullptr) {
+      const auto next = curr->next.load(relaxed);
+      delete curr;
+      curr = next;
+    }
+  }
+
+  void enqueue(pointer elem) {
+    while (true) {
+      auto tail = this->m_tail.load(acquire);
+      const auto idx = tail->enq_idx.fetch_add(1, acq_rel);
+      if (idx < NODE_SIZE) {
+        T* expected = nullptr;
+        if (tail->slots[idx].compare_exchange_strong(expected, elem, release, relaxed)) {
+          return;
+        }
+
+        continue;
+      }
+
+      if (tail != this->m_tail.load(acquire)) {
+        continue;
+      }
+
+      auto next = tail->next.load(acquire);
+      if (next == nullptr) {
+        const auto node = new node_t(elem);
+        if (tail->next.compare_exchange_strong(next, node, release, relaxed)) {
+          this->m_tail.compare_exchange_strong(tail, node, release, relaxed);
+          return;
+        }
+
+        delete node;
+      } else {
+        this->m_tail.compare_exchange_strong(tail, next, release, relaxed);
+      }
+    }
+  }
+
+  pointer dequeue() {
+    while (true) {
+      auto head = this->m_head.load(acquire);
+      if (
+          head->deq_idx.load(acquire) >= head->enq_idx.load(acquire)
+          && head->next.load(acquire) == nullptr
+      ) {
+        return nullptr;
+      }
+
+      const auto idx = head->deq_idx.fetch_add(1, acq_rel);
+      if (idx >= NODE_SIZE) {
+        auto next = head->next.load(acquire);
+        if (next == nullptr) {
+          return nullptr;
+        }
+
+        this->m_head.compare_exchange_strong(head, next, release, relaxed);
+        continue;
+      }
+
+      const auto res = head->slots[idx].exchange(taken(), acq_rel);
+      if (res != nullptr) {
+        return res;
+      }
+    }
+  }
+
+private:
+  /** marker for slots from which an element has been taken (or which have been abandoned) */
+  static T* taken() {
+    return reinterpret_cast<T*>(std::uintptr_t{ 1 });
+  }
+
+  node_t* m_first;
+  alignas(CACHE_LINE_ALIGN) std::atomic<node_t*> m_head;
+  alignas(CACHE_LINE_ALIGN) std::atomic<node_t*> m_tail;
+};
+}
+
+#endif /* LOO_BENCH_BASELINES_HPP */
@@ -0,0 +1,512 @@
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "looqueue/executor.hpp"
+#include "looqueue/huge_page_arena.hpp"
+#include "looqueue/multi_queue.hpp"
+#include "looqueue/numa_queue.hpp"
+#include "looqueue/priority_queue.hpp"
+#include "looqueue/queue.hpp"
+
+#include "baselines.hpp"
+#include "harness.hpp"
+
+namespace {
+using bench::elem_t;
+
+/** a NUMA queue w/ 2 emulated nodes (for systems w/o multiple NUMA nodes) */
+struct numa2_queue : loo::numa_queue<elem_t> {
+  numa2_queue() : loo::numa_queue<elem_t>(loo::numa_topology::emulate(2)) {}
+};
+
+/** a multi queue w/ K shards using the given choice strategy */
+template <std::size_t K, loo::multi_queue_choice Choice = loo::multi_queue_choice::RANDOM>
+struct multi_k_queue : loo::multi_queue<elem_t> {
+  multi_k_queue() :
+    loo::multi_queue<elem_t>(loo::multi_queue_options{ .shards = K, .choice = Choice }) {}
+};
+
+/** a queue allocating its nodes from a huge page arena (through a node pool) */
+struct huge_page_queue {
+  using queue_type = loo::queue<elem_t>;
+  static constexpr auto MAX_PRODUCER_THREADS = queue_type::MAX_PRODUCER_THREADS;
+  static constexpr auto MAX_CONSUMER_THREADS = queue_type::MAX_CONSUMER_THREADS;
+
+  loo::huge_page_arena arena{};
+  loo::node_pool       pool{ queue_type::DEFAULT_POOL_CAPACITY, &this->arena };
+  queue_type           queue{ this->pool };
+
+  void enqueue(elem_t* elem) {
+    this->queue.enqueue(elem);
+  }
+
+  elem_t* dequeue() {
+    return this->queue.dequeue();
+  }
+};
+
+/**
+ * chooses the lane of the calling thread's next element, `UrgentPercent`% of all elements are
+ * spread uniformly across the urgent lanes [0, Lanes - 1), all others go to the bulk lane
+ */
+template <std::size_t Lanes, std::size_t UrgentPercent>
+std::size_t choose_lane() {
+  static_assert(Lanes > 1, "at least one urgent and one bulk lane are required");
+  thread_local bench::xorshift_t rng{ std::hash<std::thread::id>{}(std::this_thread::get_id()) };
+  const auto rand = rng();
+  return rand % 100 < UrgentPercent ? std::size_t(rand / 100 % (Lanes - 1)) : Lanes - 1;
+}
+
+/** a priority queue w/ `Lanes` lanes, to which elements are distributed by `choose_lane` */
+template <std::size_t Lanes, std::size_t UrgentPercent>
+struct priority_lanes_queue : loo::priority_queue<elem_t, Lanes> {
+  void enqueue(elem_t* elem) {
+    loo::priority_queue<elem_t, Lanes>::enqueue(choose_lane<Lanes, UrgentPercent>(), elem);
+  }
+};
+
+/** the same lanes as `priority_lanes_queue`, but consumers probe each lane in order */
+template <std::size_t Lanes, std::size_t UrgentPercent>
+struct polled_lanes_queue {
+  using queue_type = loo::queue<elem_t>;
+  static constexpr auto MAX_PRODUCER_THREADS = queue_type::MAX_PRODUCER_THREADS;
+  static constexpr auto MAX_CONSUMER_THREADS = queue_type::MAX_CONSUMER_THREADS;
+
+  std::array<queue_type, Lanes> lanes{};
+
+  void enqueue(elem_t* elem) {
+    this->lanes[choose_lane<Lanes, UrgentPercent>()].enqueue(elem);
+  }
+
+  elem_t* dequeue() {
+    for (auto& lane : this->lanes) {
+      if (const auto res = lane.dequeue(); res != nullptr) {
+        return res;
+      }
+    }
+
+    return nullptr;
+  }
+};
+
+constexpr auto TWO_CHOICE = loo::multi_queue_choice::TWO_CHOICE;
+
+/**
+ * a thread pool, whose workers take every task from a single shared `loo::queue` (parked in
+ * `wait_dequeue`), as the baseline for `loo::executor`
+ */
+class global_queue_executor {
+public:
+  explicit global_queue_executor(std::size_t workers) {
+    for (std::size_t worker = 0; worker < workers; ++worker) {
+      this->m_threads.emplace_back([this] {
+        while (true) {
+          const auto task = this->m_queue.wait_dequeue();
+          if (task == &this->m_stop) {
+            return;
+          }
+
+          (*task)();
+          delete task;
+        }
+      });
+    }
+  }
+
+  /** all tasks must have completed, since workers stop once they dequeue a stop marker */
+  ~global_queue_executor() noexcept {
+    for (std::size_t worker = 0; worker < this->m_threads.size(); ++worker) {
+      this->m_queue.enqueue(&this->m_stop);
+    }
+
+    for (auto& thread : this->m_threads) {
+      thread.join();
+    }
+  }
+
+  template <typename F>
+  void submit(F&& fn) {
+    this->m_queue.enqueue(new std::function<void()>(std::forward<F>(fn)));
+  }
+
+private:
+  loo::queue<std::function<void()>, 1024, loo::blocking> m_queue{};
+  std::function<void()>                                  m_stop{};
+  std::vector<std::thread>                               m_threads{};
+};
+
+/**
+ * all benchmarked queue types by name, the `loo-N` variants use nodes with N slots, which trades
+ * the frequency of the slow path against the memory footprint (and max. thread count), `loo-hb`
+ * stores indices in the high pointer bits instead of the low bits and `loo-stats` counts events,
+ * `numa` shards the queue per NUMA node and `numa-2` emulates 2 nodes, `multi-K` are relaxed multi
+ * queues w/ K shards (`-2c` for the two-choice strategy), `loo-spsc`, `loo-spmc` and `loo-mpsc` use
+ * single producer and/or consumer roles (configurations w/ more threads per role are skipped),
+ * `loo-huge` allocates its nodes from huge pages, `loo-spare` prepares spare nodes and `loo-spin`
+ * and `loo-adaptive` wait for reserved slots to be written (both count events, like `loo-stats`),
+ * `loo-compact` allocates its nodes lazily, grows them from 8 slots and pads neither head nor tail,
+ * `loo-blocking` supports blocking (and async) consumers, which every enqueue has to check for,
+ * `prio-L` are priority queues w/ L lanes and `lanes-L` separate queues polled in order (uniform
+ * lane distribution or 10% urgent elements w/ `-skew`)
+ */
+const std::map<std::string, bench::runner_t> RUNNERS = {
+    { "loo",         bench::run_workload<loo::queue<elem_t>> },
+    { "loo-64",      bench::run_workload<loo::queue<elem_t, 64>> },
+    { "loo-256",     bench::run_workload<loo::queue<elem_t, 256>> },
+    { "loo-4096",    bench::run_workload<loo::queue<elem_t, 4096>> },
+    { "loo-16384",   bench::run_workload<loo::queue<elem_t, 16384>> },
+    { "loo-hb",      bench::run_workload<loo::queue<elem_t, 1024, loo::high_bit_tagging<>>> },
+    { "loo-stats",   bench::run_workload<loo::queue<elem_t, 1024, loo::sharded_stats<>>> },
+    { "loo-spsc",    bench::run_workload<
+        loo::queue<elem_t, 1024, loo::single_producer, loo::single_consumer>
+    > },
+    { "loo-spmc",    bench::run_workload<loo::queue<elem_t, 1024, loo::single_producer>> },
+    { "loo-mpsc",    bench::run_workload<loo::queue<elem_t, 1024, loo::single_consumer>> },
+    { "loo-huge",    bench::run_workload<huge_page_queue> },
+    { "loo-spare",   bench::run_workload<loo::queue<elem_t, 1024, loo::spare_node<>>> },
+    { "loo-spin",    bench::run_workload<
+        loo::queue<elem_t, 1024, loo::spin_wait<>, loo::sharded_stats<>>
+    > },
+    { "loo-adaptive", bench::run_workload<
+        loo::queue<elem_t, 1024, loo::adaptive_wait<>, loo::sharded_stats<>>
+    > },
+    { "loo-compact", bench::run_workload<
+        loo::queue<elem_t, 1024, loo::high_bit_tagging<>, loo::growing_nodes<>, loo::no_padding>
+    > },
+    { "loo-blocking", bench::run_workload<loo::queue<elem_t, 1024, loo::blocking>> },
+    { "prio-4",       bench::run_workload<priority_lanes_queue<4, 75>> },
+    { "prio-4-skew",  bench::run_workload<priority_lanes_queue<4, 10>> },
+    { "prio-8-skew",  bench::run_workload<priority_lanes_queue<8, 10>> },
+    { "lanes-4",      bench::run_workload<polled_lanes_queue<4, 75>> },
+    { "lanes-4-skew", bench::run_workload<polled_lanes_queue<4, 10>> },
+    { "lanes-8-skew", bench::run_workload<polled_lanes_queue<8, 10>> },
+    { "numa",        bench::run_workload<loo::numa_queue<elem_t>> },
+    { "numa-2",      bench::run_workload<numa2_queue> },
+    { "multi-2",     bench::run_workload<multi_k_queue<2>> },
+    { "multi-4",     bench::run_workload<multi_k_queue<4>> },
+    { "multi-8",     bench::run_workload<multi_k_queue<8>> },
+    { "multi-16",    bench::run_workload<multi_k_queue<16>> },
+    { "multi-4-2c",  bench::run_workload<multi_k_queue<4, TWO_CHOICE>> },
+    { "multi-16-2c", bench::run_workload<multi_k_queue<16, TWO_CHOICE>> },
+    { "mutex",       bench::run_workload<bench::mutex_queue<elem_t>> },
+    { "ms",          bench::run_workload<bench::ms_queue<elem_t>> },
+    { "faa",         bench::run_workload<bench::faa_array_queue<elem_t>> },
+};
+
+/** all queue types for which the rank error can be measured (with `--rank-error`) */
+const std::map<std::string, bench::rank_runner_t> RANK_RUNNERS = {
+    { "loo",         bench::run_rank_error<loo::queue<elem_t>> },
+    { "numa-2",      bench::run_rank_error<numa2_queue> },
+    { "multi-2",     bench::run_rank_error<multi_k_queue<2>> },
+    { "multi-4",     bench::run_rank_error<multi_k_queue<4>> },
+    { "multi-8",     bench::run_rank_error<multi_k_queue<8>> },
+    { "multi-16",    bench::run_rank_error<multi_k_queue<16>> },
+    { "multi-4-2c",  bench::run_rank_error<multi_k_queue<4, TWO_CHOICE>> },
+    { "multi-16-2c", bench::run_rank_error<multi_k_queue<16, TWO_CHOICE>> },
+};
+
+/** all queue types for which the enqueue latency can be measured (with `--latency`) */
+const std::map<std::string, bench::latency_runner_t> LATENCY_RUNNERS = {
+    { "loo",            bench::run_latency<loo::queue<elem_t>> },
+    { "loo-64",         bench::run_latency<loo::queue<elem_t, 64>> },
+    { "loo-4096",       bench::run_latency<loo::queue<elem_t, 4096>> },
+    { "loo-spare",      bench::run_latency<loo::queue<elem_t, 1024, loo::spare_node<>>> },
+    { "loo-64-spare",   bench::run_latency<loo::queue<elem_t, 64, loo::spare_node<>>> },
+    { "loo-4096-spare", bench::run_latency<loo::queue<elem_t, 4096, loo::spare_node<>>> },
+    { "loo-huge",       bench::run_latency<huge_page_queue> },
+    { "loo-poll",       bench::run_latency<loo::queue<elem_t>, true> },
+    { "ms",             bench::run_latency<bench::ms_queue<elem_t>> },
+};
+
+/**
+ * all executors whose task throughput can be measured (with `--executor`), `loo` is the
+ * work-stealing `loo::executor`, `global` takes every task from a single shared `loo::queue`
+ */
+const std::map<std::string, bench::executor_runner_t> EXECUTOR_RUNNERS = {
+    { "loo",    bench::run_executor<loo::executor> },
+    { "global", bench::run_executor<global_queue_executor> },
+};
+
+void print_usage() {
+  std::cerr
+      << "usage: bench_loo [options]\n"
+      << "  --queues=loo,mutex,ms,faa                  queues to benchmark\n"
+      << "                                             (node sizes: loo-64,loo-256,loo-4096,loo-16384)\n"
+      << "                                             (high-bit tagging: loo-hb, stats: loo-stats)\n"
+      << "                                             (roles: loo-spsc,loo-spmc,loo-mpsc)\n"
+      << "                                             (huge page nodes: loo-huge)\n"
+      << "                                             (spare nodes: loo-spare)\n"
+      << "                                             (wait policies: loo-spin,loo-adaptive)\n"
+      << "                                             (lazy, growing nodes: loo-compact)\n"
+      << "                                             (blocking consumers: loo-blocking)\n"
+      << "                                             (priority lanes: prio-4,prio-4-skew,\n"
+      << "                                              prio-8-skew, polled: lanes-4,...)\n"
+      << "                                             (NUMA sharding: numa, numa-2)\n"
+      << "                                             (relaxed: multi-2,multi-4,multi-8,multi-16,\n"
+      << "                                              multi-4-2c,multi-16-2c)\n"
+      << "  --workloads=pairs,mixed,phases,prodcons    workloads to run (also: async)\n"
+      << "  --threads=1,2,4,...                        thread counts to sweep\n"
+      << "  --ratios=1:1,1:3,3:1                       producer:consumer ratios (prodcons, async)\n"
+      << "  --ops=N                                    total operations per run\n"
+      << "  --prefill=N                                elements inserted before each run\n"
+      << "  --runs=N                                   repetitions per configuration\n"
+      << "  --pin                                      pin worker threads to CPUs\n"
+      << "  --format=csv|json                          output format\n"
+      << "  --dtlb                                     count dTLB loads and misses per operation\n"
+      << "                                             (e.g., w/ a deep backlog: --prefill=4000000)\n"
+      << "  --perf                                     count cycles, instructions, L1d/LLC, dTLB\n"
+      << "                                             and branch misses per operation\n"
+      << "  --stats                                    report abandoned slots per operation\n"
+      << "                                             (loo-stats,loo-spin,loo-adaptive only)\n"
+      << "  --rank-error                               measure the rank error (single-threaded)\n"
+      << "                                             instead of throughput\n"
+      << "  --latency                                  measure the enqueue latency percentiles\n"
+      << "                                             instead of throughput\n"
+      << "  --pollers=N                                consumers per run w/ --latency (default:\n"
+      << "                                             one per producer)\n"
+      << "  --executor                                 measure the task throughput of executors\n"
+      << "                                             (--queues=loo,global and\n"
+      << "                                             --workloads=fork-join,fan-out)\n";
+}
+
+std::vector<std::string> split(std::string_view list) {
+  std::vector<std::string> res{};
+  std::stringstream stream{ std::string(list) };
+  for (std::string item; std::getline(stream, item, ',');) {
+    if (!item.empty()) {
+      res.push_back(item);
+    }
+  }
+
+  return res;
+}
+
+bool parse_args(int argc, char* argv[], bench::config_t& cfg) {
+  bool queues_given = false;
+  bool workloads_given = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg{ argv[i] };
+    const auto eq = arg.find('=');
+    const auto key = arg.substr(0, eq);
+    const auto value = eq == std::string_view::npos ? std::string_view{} : arg.substr(eq + 1);
+
+    if (key == "--queues") {
+      cfg.queues = split(value);
+      queues_given = true;
+    } else if (key == "--workloads") {
+      cfg.workloads = split(value);
+      workloads_given = true;
+    } else if (key == "--threads") {
+      cfg.threads.clear();
+      for (const auto& item : split(value)) {
+        cfg.threads.push_back(std::stoul(item));
+      }
+    } else if (key == "--ratios") {
+      cfg.ratios.clear();
+      for (const auto& item : split(value)) {
+        const auto colon = item.find(':');
+        cfg.ratios.push_back({ std::stoul(item.substr(0, colon)), std::stoul(item.substr(colon + 1)) });
+      }
+    } else if (key == "--ops") {
+      cfg.ops = std::stoul(std::string(value));
+    } else if (key == "--prefill") {
+      cfg.prefill = std::stoul(std::string(value));
+    } else if (key == "--runs") {
+      cfg.runs = std::stoul(std::string(value));
+    } else if (key == "--pin") {
+      cfg.pin = true;
+    } else if (key == "--format") {
+      cfg.format = value;
+    } else if (key == "--rank-error") {
+      cfg.rank_error = true;
+    } else if (key == "--dtlb") {
+      cfg.dtlb = true;
+    } else if (key == "--perf") {
+      cfg.perf = true;
+    } else if (key == "--stats") {
+      cfg.stats = true;
+    } else if (key == "--latency") {
+      cfg.latency = true;
+    } else if (key == "--executor") {
+      cfg.executor = true;
+    } else if (key == "--pollers") {
+      cfg.pollers = std::stoul(std::string(value));
+    } else {
+      return false;
+    }
+  }
+
+  if (cfg.rank_error && !queues_given) {
+    cfg.queues.clear();
+    for (const auto& [queue, _] : RANK_RUNNERS) {
+      cfg.queues.push_back(queue);
+    }
+  } else if (cfg.latency && !queues_given) {
+    cfg.queues = { "loo", "loo-spare" };
+  } else if (cfg.executor && !queues_given) {
+    cfg.queues = { "loo", "global" };
+  }
+
+  if (cfg.executor && !workloads_given) {
+    cfg.workloads = bench::EXECUTOR_WORKLOADS;
+  }
+
+  for (const auto& queue : cfg.queues) {
+    const auto known = cfg.rank_error
+        ? RANK_RUNNERS.contains(queue)
+        : cfg.latency ? LATENCY_RUNNERS.contains(queue)
+        : cfg.executor ? EXECUTOR_RUNNERS.contains(queue) : RUNNERS.contains(queue);
+    if (!known) {
+      std::cerr << "unknown queue: " << queue << std::endl;
+      return false;
+    }
+  }
+
+  for (const auto& workload : cfg.workloads) {
+    const auto known = cfg.executor
+        ? std::ranges::find(bench::EXECUTOR_WORKLOADS, workload) != bench::EXECUTOR_WORKLOADS.end()
+        : !bench::phase_names(workload).empty();
+    if (!known) {
+      std::cerr << "unknown workload: " << workload << std::endl;
+      return false;
+    }
+  }
+
+  if (cfg.threads.empty()) {
+    const auto max = std::max(2u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= max; threads *= 2) {
+      cfg.threads.push_back(threads);
+    }
+  }
+
+  return true;
+}
+
+/** returns all run configurations resulting from sweeping over thread counts and ratios */
+std::vector<bench::run_config_t> sweep(
+    const bench::config_t& cfg,
+    const std::string& workload,
+    const std::vector<bench::perf_event_t>& events
+) {
+  std::vector<bench::run_config_t> res{};
+  for (const auto threads : cfg.threads) {
+    if (workload != "prodcons" && workload != "async") {
+      res.push_back({ workload, threads, threads, threads, cfg.ops, cfg.prefill, cfg.pin, events });
+      continue;
+    }
+
+    if (threads < 2) {
+      continue;
+    }
+
+    for (const auto [p, c] : cfg.ratios) {
+      // ratios may collapse into the same split for small thread counts
+      const auto producers = std::clamp<std::size_t>(threads * p / (p + c), 1, threads - 1);
+      const auto duplicate = std::any_of(res.begin(), res.end(), [&](const auto& run_cfg) {
+        return run_cfg.threads == threads && run_cfg.producers == producers;
+      });
+
+      if (duplicate) {
+        continue;
+      }
+
+      res.push_back({
+          workload, threads, producers, threads - producers, cfg.ops, cfg.prefill, cfg.pin, events
+      });
+    }
+  }
+
+  return res;
+}
+}
+
+int main(int argc, char* argv[]) {
+  bench::config_t cfg{};
+  if (!parse_args(argc, argv, cfg)) {
+    print_usage();
+    return 1;
+  }
+
+  if (cfg.rank_error) {
+    std::vector<bench::rank_error_t> errors{};
+    for (const auto& queue : cfg.queues) {
+      for (std::size_t run = 0; run < cfg.runs; ++run) {
+        errors.push_back(RANK_RUNNERS.at(queue)(queue, run, cfg.ops, cfg.prefill));
+      }
+    }
+
+    bench::write_rank_errors(std::cout, errors, cfg.format);
+    return 0;
+  }
+
+  if (cfg.latency) {
+    std::vector<bench::latency_t> latencies{};
+    for (const auto threads : cfg.threads) {
+      for (const auto& queue : cfg.queues) {
+        for (std::size_t run = 0; run < cfg.runs; ++run) {
+          latencies.push_back(LATENCY_RUNNERS.at(queue)(queue, threads, run, cfg));
+        }
+      }
+    }
+
+    bench::write_latencies(std::cout, latencies, cfg.format);
+    return 0;
+  }
+
+  if (cfg.executor) {
+    std::vector<bench::executor_sample_t> samples{};
+    for (const auto& workload : cfg.workloads) {
+      for (const auto threads : cfg.threads) {
+        for (const auto& executor : cfg.queues) {
+          for (std::size_t run = 0; run < cfg.runs; ++run) {
+            const auto& runner = EXECUTOR_RUNNERS.at(executor);
+            samples.push_back(runner(executor, workload, threads, run, cfg.ops));
+          }
+        }
+      }
+    }
+
+    bench::write_executor_samples(std::cout, samples, cfg.format);
+    return 0;
+  }
+
+  const auto events = bench::configured_events(cfg);
+  if (const auto missing = bench::unavailable_events(events); !missing.empty()) {
+    // e.g., in containers or VMs w/o access to the PMU or w/ a restrictive perf_event_paranoid
+    std::cerr << "unavailable events (left empty):";
+    for (const auto& name : missing) {
+      std::cerr << ' ' << name;
+    }
+
+    std::cerr << std::endl;
+  }
+
+  std::vector<bench::sample_t> samples{};
+  for (const auto& workload : cfg.workloads) {
+    const auto phases = bench::phase_names(workload);
+    for (const auto& run_cfg : sweep(cfg, workload, events)) {
+      for (const auto& queue : cfg.queues) {
+        for (std::size_t run = 0; run < cfg.runs; ++run) {
+          const auto results = RUNNERS.at(queue)(run_cfg);
+          for (std::size_t phase = 0; phase < results.size(); ++phase) {
+            samples.push_back({
+                queue, phases[phase], run_cfg.threads, run_cfg.producers, run_cfg.consumers, run,
+                run_cfg.ops, results[phase].seconds, results[phase].perf.counts,
+                results[phase].abandoned
+            });
+          }
+        }
+      }
+    }
+  }
+
+  bench::write_samples(std::cout, samples, cfg.format, events, cfg.stats);
+}
@@ -0,0 +1,910 @@
+#ifndef LOO_BENCH_HARNESS_HPP
+#define LOO_BENCH_HARNESS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "perf.hpp"
+
+namespace bench {
+/** the element type all benchmarked queues transport (pointers to) */
+using elem_t = std::uint64_t;
+
+/** a producer:consumer thread ratio */
+struct ratio_t {
+  std::size_t producers, consumers;
+};
+
+/** the configuration for all benchmark runs */
+struct config_t {
+  std::vector<std::string> queues{ "loo", "mutex", "ms", "faa" };
+  std::vector<std::string> workloads{ "pairs", "mixed", "phases", "prodcons" };
+  std::vector<std::size_t> threads{ };
+  std::vector<ratio_t>     ratios{ { 1, 1 }, { 1, 3 }, { 3, 1 } };
+  /** the total number of operations per run (shared by all threads) */
+  std::size_t              ops{ 1u << 22 };
+  /** the number of elements inserted before each (timed) run */
+  std::size_t              prefill{ 0 };
+  /** the number of repetitions for each distinct combination */
+  std::size_t              runs{ 5 };
+  /** pin each worker thread to a distinct CPU */
+  bool                     pin{ false };
+  /** the output format, either "csv" or "json" */
+  std::string              format{ "csv" };
+  /** measure the rank error of all (relaxed) queues instead of throughput */
+  bool                     rank_error{ false };
+  /** count dTLB loads and misses of all worker threads */
+  bool                     dtlb{ false };
+  /** count cycles, instructions, cache, dTLB and branch misses of all worker threads */
+  bool                     perf{ false };
+  /** measure the enqueue latency distribution instead of throughput */
+  bool                     latency{ false };
+  /** the number of consumers polling the queue w/ `--latency` (0 means one per producer) */
+  std::size_t              pollers{ 0 };
+  /** measure the task throughput of executors (fork-join, fan-out) instead of queues */
+  bool                     executor{ false };
+  /** report the abandoned slots per operation (queues counting events only) */
+  bool                     stats{ false };
+};
+
+/** the parameters for a single run */
+struct run_config_t {
+  std::string               workload;
+  std::size_t               threads, producers, consumers;
+  std::size_t               ops, prefill;
+  bool                      pin;
+  /** the events counted for each worker thread */
+  std::vector<perf_event_t> events;
+};
+
+/** the result of a single timed phase of a run */
+struct phase_t {
+  double                       seconds;
+  perf_totals_t                perf;
+  /** the number of abandoned slots (empty unless the queue counts events) */
+  std::optional<std::uint64_t> abandoned{};
+};
+
+/** the result of a single (timed) run */
+struct sample_t {
+  std::string queue, workload;
+  std::size_t threads, producers, consumers;
+  std::size_t run;
+  std::size_t ops;
+  double      seconds;
+  /** the total count of each event (empty if unavailable) */
+  std::vector<std::optional<double>> counts{};
+  /** the number of abandoned slots (empty unless the queue counts events) */
+  std::optional<std::uint64_t>       abandoned{};
+
+  [[nodiscard]] double mops() const {
+    return double(this->ops) / this->seconds / 1e6;
+  }
+
+  /** returns the count of the event with index `idx` per operation */
+  [[nodiscard]] std::optional<double> per_op(std::size_t idx) const {
+    if (idx >= this->counts.size() || !this->counts[idx]) {
+      return std::nullopt;
+    }
+
+    return *this->counts[idx] / double(this->ops);
+  }
+
+  /** returns the number of abandoned slots per operation */
+  [[nodiscard]] std::optional<double> abandoned_per_op() const {
+    if (!this->abandoned) {
+      return std::nullopt;
+    }
+
+    return double(*this->abandoned) / double(this->ops);
+  }
+};
+
+/** a small and fast per-thread PRNG (xorshift64*) */
+class xorshift_t {
+public:
+  explicit xorshift_t(std::uint64_t seed) : m_state{ seed == 0 ? 0x9E3779B97F4A7C15ull : seed } {}
+
+  std::uint64_t operator()() {
+    this->m_state ^= this->m_state >> 12;
+    this->m_state ^= this->m_state << 25;
+    this->m_state ^= this->m_state >> 27;
+    return this->m_state * 0x2545F4914F6CDD1Dull;
+  }
+
+private:
+  std::uint64_t m_state;
+};
+
+/** pins the calling thread to the given CPU (if supported) */
+inline void pin_thread(std::size_t cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % std::thread::hardware_concurrency(), &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+#else
+  (void) cpu;
+#endif
+}
+
+/**
+ * Runs `fn(thread_id)` on `threads` concurrently started worker threads and returns the elapsed
+ * wall-clock time in seconds between starting the first and completing the last thread as well as
+ * the configured event counts summed over all threads.
+ */
+template <typename F>
+phase_t run_threads(const run_config_t& cfg, std::size_t threads, F&& fn) {
+  std::atomic_size_t ready{ 0 };
+  std::atomic_bool   start{ false };
+  std::mutex         perf_lock{};
+  perf_totals_t      perf{};
+
+  std::vector<std::thread> workers{};
+  workers.reserve(threads);
+
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    workers.emplace_back([&, thread] {
+      if (cfg.pin) {
+        pin_thread(thread);
+      }
+
+      // the counters are opened before and read after the timed section
+      perf_counters_t counters{ cfg.events };
+      ready.fetch_add(1);
+      while (!start.load()) {}
+      counters.start();
+      fn(thread);
+      counters.stop();
+
+      const auto counts = counters.read();
+      std::lock_guard guard{ perf_lock };
+      perf.add(counts);
+    });
+  }
+
+  while (ready.load() < threads) {}
+  const auto begin = std::chrono::steady_clock::now();
+  start.store(true);
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+  return { std::chrono::duration<double>(end - begin).count(), std::move(perf) };
+}
+
+/** returns the number of slots abandoned so far, if the queue counts events */
+template <typename Q>
+std::optional<std::uint64_t> abandoned_slots(Q& queue) {
+  if constexpr (requires { queue.stats(); }) {
+    // every queue allocates its initial node, so no allocations means events are not counted
+    if (const auto stats = queue.stats(); stats.nodes_allocated != 0) {
+      return stats.abandoned_slots;
+    }
+  }
+
+  return std::nullopt;
+}
+
+/** like `run_threads`, but also counts the slots abandoned during the phase (if possible) */
+template <typename Q, typename F>
+phase_t run_phase(Q& queue, const run_config_t& cfg, std::size_t threads, F&& fn) {
+  const auto before = abandoned_slots(queue);
+  auto phase = run_threads(cfg, threads, std::forward<F>(fn));
+  if (const auto after = abandoned_slots(queue); before && after) {
+    phase.abandoned = *after - *before;
+  }
+
+  return phase;
+}
+
+/** returns a pointer to some (non-null) element */
+inline elem_t* element(std::size_t idx) {
+  static elem_t elements[1024]{ };
+  return &elements[idx % 1024];
+}
+
+/** splits `total` evenly among `parts` and returns the share of part `idx` */
+inline std::size_t share(std::size_t total, std::size_t parts, std::size_t idx) {
+  return total / parts + (idx < total % parts ? 1 : 0);
+}
+
+/** each thread alternates between enqueue and dequeue operations */
+template <typename Q>
+std::vector<phase_t> run_pairs(Q& queue, const run_config_t& cfg) {
+  return { run_phase(queue, cfg, cfg.threads, [&](std::size_t thread) {
+    const auto pairs = share(cfg.ops / 2, cfg.threads, thread);
+    for (std::size_t op = 0; op < pairs; ++op) {
+      queue.enqueue(element(op));
+      queue.dequeue();
+    }
+  }) };
+}
+
+/** each thread randomly chooses between enqueue and dequeue operations with equal probability */
+template <typename Q>
+std::vector<phase_t> run_mixed(Q& queue, const run_config_t& cfg) {
+  return { run_phase(queue, cfg, cfg.threads, [&](std::size_t thread) {
+    xorshift_t rng{ thread + 1 };
+    const auto ops = share(cfg.ops, cfg.threads, thread);
+    for (std::size_t op = 0; op < ops; ++op) {
+      if ((rng() & 1) == 0) {
+        queue.enqueue(element(op));
+      } else {
+        queue.dequeue();
+      }
+    }
+  }) };
+}
+
+/** all threads first only enqueue and then only dequeue elements (two separately timed phases) */
+template <typename Q>
+std::vector<phase_t> run_phases(Q& queue, const run_config_t& cfg) {
+  const auto enqueue = run_phase(queue, cfg, cfg.threads, [&](std::size_t thread) {
+    const auto ops = share(cfg.ops, cfg.threads, thread);
+    for (std::size_t op = 0; op < ops; ++op) {
+      queue.enqueue(element(op));
+    }
+  });
+
+  const auto dequeue = run_phase(queue, cfg, cfg.threads, [&](std::size_t thread) {
+    const auto ops = share(cfg.ops, cfg.threads, thread);
+    for (std::size_t op = 0; op < ops; ++op) {
+      queue.dequeue();
+    }
+  });
+
+  return { enqueue, dequeue };
+}
+
+/** dedicated producer and consumer threads, consumers dequeue until all elements are consumed */
+template <typename Q>
+std::vector<phase_t> run_prodcons(Q& queue, const run_config_t& cfg) {
+  const auto elements = cfg.ops / 2;
+  return { run_phase(queue, cfg, cfg.producers + cfg.consumers, [&](std::size_t thread) {
+    if (thread < cfg.producers) {
+      const auto ops = share(elements, cfg.producers, thread);
+      for (std::size_t op = 0; op < ops; ++op) {
+        queue.enqueue(element(op));
+      }
+    } else {
+      const auto ops = share(elements, cfg.consumers, thread - cfg.producers);
+      for (std::size_t op = 0; op < ops;) {
+        if (queue.dequeue() != nullptr) {
+          ++op;
+        }
+      }
+    }
+  }) };
+}
+
+/** an executor resuming coroutines on a single (polling) worker thread */
+class thread_executor_t {
+public:
+  void execute(std::coroutine_handle<> handle) {
+    std::lock_guard guard{ this->m_lock };
+    this->m_ready.push_back(handle);
+  }
+
+  /** resumes all currently scheduled coroutines */
+  void run_ready() {
+    std::deque<std::coroutine_handle<>> ready{};
+    {
+      std::lock_guard guard{ this->m_lock };
+      ready.swap(this->m_ready);
+    }
+
+    for (const auto handle : ready) {
+      handle.resume();
+    }
+  }
+
+private:
+  std::mutex                          m_lock{};
+  std::deque<std::coroutine_handle<>> m_ready{};
+};
+
+/** a coroutine, which starts eagerly and destroys itself once it completes */
+struct detached_t {
+  struct promise_type {
+    detached_t get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+/** the number of consumer coroutines per consumer thread in the async workload */
+constexpr std::size_t ASYNC_COROUTINES = 64;
+
+/** dequeues elements through `async_dequeue` until `stop` is dequeued */
+template <typename Q>
+detached_t consume_async(
+    Q& queue, thread_executor_t& executor, const elem_t* stop, std::size_t& live
+) {
+  while (true) {
+    const auto elem = co_await queue.async_dequeue(executor);
+    if (elem == stop) {
+      break;
+    }
+  }
+
+  --live;
+}
+
+/**
+ * dedicated producer threads and consumer threads, each of which runs `ASYNC_COROUTINES`
+ * coroutines dequeuing through `async_dequeue` (queues w/o `async_dequeue` are skipped)
+ */
+template <typename Q>
+std::vector<phase_t> run_async(Q& queue, const run_config_t& cfg) {
+  if constexpr (requires(thread_executor_t& executor) { queue.async_dequeue(executor); }) {
+    static elem_t stop{ };
+    const auto elements = cfg.ops / 2;
+    std::atomic_size_t producers{ cfg.producers };
+    return { run_phase(queue, cfg, cfg.producers + cfg.consumers, [&](std::size_t thread) {
+      if (thread < cfg.producers) {
+        const auto ops = share(elements, cfg.producers, thread);
+        for (std::size_t op = 0; op < ops; ++op) {
+          queue.enqueue(element(op));
+        }
+
+        // the final producer stops all consumer coroutines
+        if (producers.fetch_sub(1) == 1) {
+          for (std::size_t i = 0; i < cfg.consumers * ASYNC_COROUTINES; ++i) {
+            queue.enqueue(&stop);
+          }
+        }
+      } else {
+        thread_executor_t executor{};
+        std::size_t live = ASYNC_COROUTINES;
+        for (std::size_t i = 0; i < ASYNC_COROUTINES; ++i) {
+          consume_async(queue, executor, &stop, live);
+        }
+
+        while (live != 0) {
+          executor.run_ready();
+        }
+      }
+    }) };
+  } else {
+    return { };
+  }
+}
+
+/** the names of the timed phases of each workload (none for unknown workloads) */
+inline std::vector<std::string> phase_names(const std::string& workload) {
+  if (workload == "phases") {
+    return { "enqueue_only", "dequeue_only" };
+  } else if (
+      workload == "pairs" || workload == "mixed" || workload == "prodcons" || workload == "async"
+  ) {
+    return { workload };
+  }
+
+  return { };
+}
+
+/**
+ * constructs a new queue of type Q and runs the configured workload on it, configurations exceeding
+ * the queue's thread limits are skipped (no timings)
+ */
+template <typename Q>
+std::vector<phase_t> run_workload(const run_config_t& cfg) {
+  if constexpr (requires { Q::MAX_CONSUMER_THREADS; }) {
+    if (cfg.producers > Q::MAX_PRODUCER_THREADS || cfg.consumers > Q::MAX_CONSUMER_THREADS) {
+      return { };
+    }
+  }
+
+  Q queue{};
+  for (std::size_t i = 0; i < cfg.prefill; ++i) {
+    queue.enqueue(element(i));
+  }
+
+  if (cfg.workload == "pairs") {
+    return run_pairs(queue, cfg);
+  } else if (cfg.workload == "mixed") {
+    return run_mixed(queue, cfg);
+  } else if (cfg.workload == "phases") {
+    return run_phases(queue, cfg);
+  } else if (cfg.workload == "async") {
+    return run_async(queue, cfg);
+  } else {
+    return run_prodcons(queue, cfg);
+  }
+}
+
+/** type-erased workload runner for a specific queue type */
+using runner_t = std::function<std::vector<phase_t>(const run_config_t&)>;
+
+/** the rank errors observed by all dequeue operations of a single run */
+struct rank_error_t {
+  std::string queue;
+  std::size_t run;
+  std::size_t ops, prefill;
+  double      mean;
+  std::size_t max;
+};
+
+/** a Fenwick tree counting the elements currently in the queue by their enqueue order */
+class fenwick_tree_t {
+public:
+  explicit fenwick_tree_t(std::size_t size) : m_tree(size + 1, 0) {}
+
+  void add(std::size_t idx, std::int64_t value) {
+    for (++idx; idx < this->m_tree.size(); idx += idx & (~idx + 1)) {
+      this->m_tree[idx] += value;
+    }
+  }
+
+  /** returns the sum of all values in [0, idx) */
+  [[nodiscard]] std::int64_t prefix(std::size_t idx) const {
+    std::int64_t sum = 0;
+    for (; idx > 0; idx -= idx & (~idx + 1)) {
+      sum += this->m_tree[idx];
+    }
+
+    return sum;
+  }
+
+private:
+  std::vector<std::int64_t> m_tree;
+};
+
+/**
+ * Measures the rank error of queue type Q, i.e., the number of elements, which had been enqueued
+ * before, but are still in the queue when an element is dequeued (always 0 for FIFO queues).
+ *
+ * A single thread performs `prefill` enqueue operations followed by `ops` randomly chosen enqueue
+ * or dequeue operations, each element's address denotes its position in the enqueue order.
+ */
+template <typename Q>
+rank_error_t run_rank_error(
+    const std::string& name,
+    std::size_t run,
+    std::size_t ops,
+    std::size_t prefill
+) {
+  Q queue{};
+  std::vector<elem_t> elements(prefill + ops);
+  fenwick_tree_t tree{ elements.size() };
+  xorshift_t rng{ run + 1 };
+
+  std::size_t enqueued = 0, dequeued = 0, max = 0;
+  double sum = 0.0;
+  for (std::size_t op = 0; op < prefill + ops; ++op) {
+    if (op < prefill || (rng() & 1) == 0) {
+      tree.add(enqueued, 1);
+      queue.enqueue(&elements[enqueued++]);
+    } else if (const auto res = queue.dequeue(); res != nullptr) {
+      const auto idx = static_cast<std::size_t>(res - elements.data());
+      const auto rank = static_cast<std::size_t>(tree.prefix(idx));
+      tree.add(idx, -1);
+      sum += double(rank);
+      max = std::max(max, rank);
+      dequeued += 1;
+    }
+  }
+
+  return { name, run, ops, prefill, dequeued == 0 ? 0.0 : sum / double(dequeued), max };
+}
+
+/** type-erased rank error runner for a specific queue type */
+using rank_runner_t =
+    std::function<rank_error_t(const std::string&, std::size_t, std::size_t, std::size_t)>;
+
+/** the enqueue latency percentiles (in nanoseconds) observed in a single run */
+struct latency_t {
+  std::string queue;
+  std::size_t threads, consumers, run, ops;
+  double      p50, p99, p999, p9999, max;
+};
+
+/**
+ * Measures the latency of each enqueue operation of queue type Q, `threads` producers enqueue
+ * `ops` elements in total, while `cfg.pollers` consumers (as many as producers by default) dequeue
+ * them concurrently, with many consumers, these are mostly polling an empty queue.
+ *
+ * If `Polling` is set, consumers poll through `poll_dequeue_for` (read-only empty checks w/
+ * exponential backoff) instead of `dequeue`.
+ */
+template <typename Q, bool Polling = false>
+latency_t run_latency(
+    const std::string& name,
+    std::size_t threads,
+    std::size_t run,
+    const config_t& cfg
+) {
+  const auto consumers = cfg.pollers == 0 ? threads : cfg.pollers;
+  if constexpr (requires { Q::MAX_CONSUMER_THREADS; }) {
+    if (threads > Q::MAX_PRODUCER_THREADS || consumers > Q::MAX_CONSUMER_THREADS) {
+      return { name, threads, consumers, run, 0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    }
+  }
+
+  Q queue{};
+  std::mutex lock{};
+  std::vector<double> latencies{};
+  latencies.reserve(cfg.ops);
+  std::atomic<std::size_t> dequeued{ 0 };
+
+  const auto total = threads + consumers;
+  const run_config_t run_cfg{ "latency", total, threads, consumers, cfg.ops, 0, cfg.pin, {} };
+  run_threads(run_cfg, total, [&](std::size_t thread) {
+    if (thread < threads) {
+      const auto ops = share(cfg.ops, threads, thread);
+      std::vector<double> thread_latencies(ops);
+      for (std::size_t op = 0; op < ops; ++op) {
+        const auto begin = std::chrono::steady_clock::now();
+        queue.enqueue(element(op));
+        const auto end = std::chrono::steady_clock::now();
+        thread_latencies[op] = std::chrono::duration<double, std::nano>(end - begin).count();
+      }
+
+      std::lock_guard guard{ lock };
+      latencies.insert(latencies.end(), thread_latencies.begin(), thread_latencies.end());
+    } else {
+      // consumers may take any share of all elements, so they stop once all have been dequeued
+      while (dequeued.load(std::memory_order_relaxed) < cfg.ops) {
+        if constexpr (Polling) {
+          if (queue.poll_dequeue_for(std::chrono::milliseconds{ 1 }) != nullptr) {
+            dequeued.fetch_add(1, std::memory_order_relaxed);
+          }
+        } else if (queue.dequeue() != nullptr) {
+          dequeued.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  });
+
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&](double p) {
+    const auto idx = std::min(latencies.size() - 1, std::size_t(p * double(latencies.size())));
+    return latencies[idx];
+  };
+
+  return {
+      name, threads, consumers, run, cfg.ops,
+      percentile(0.5), percentile(0.99), percentile(0.999), percentile(0.9999), latencies.back()
+  };
+}
+
+/** type-erased latency runner for a specific queue type */
+using latency_runner_t =
+    std::function<latency_t(const std::string&, std::size_t, std::size_t, const config_t&)>;
+
+/** the names of all executor workloads */
+inline const std::vector<std::string> EXECUTOR_WORKLOADS{ "fork-join", "fan-out" };
+
+/** the result of a single executor run */
+struct executor_sample_t {
+  std::string executor, workload;
+  std::size_t threads, run, tasks;
+  double      seconds;
+};
+
+/** the join counter of a task waiting for both of its child tasks (see `fork_join`) */
+struct join_t {
+  std::atomic_uint32_t pending{ 2 };
+  join_t*              parent;
+};
+
+/** signals the completion of a child of `join`, the last child completes `join` itself */
+inline void complete_join(join_t* join, std::atomic_bool& done) {
+  while (join != nullptr) {
+    if (join->pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+
+    const auto parent = join->parent;
+    delete join;
+    join = parent;
+  }
+
+  done.store(true, std::memory_order_release);
+  done.notify_one();
+}
+
+/** spawns a binary tree of tasks, each of which completes once both of its children have */
+template <typename E>
+void fork_join(E& executor, std::size_t depth, join_t* parent, std::atomic_bool& done) {
+  if (depth == 0) {
+    complete_join(parent, done);
+    return;
+  }
+
+  const auto join = new join_t{ .parent = parent };
+  for (auto child = 0; child < 2; ++child) {
+    executor.submit([&executor, depth, join, &done] {
+      fork_join(executor, depth - 1, join, done);
+    });
+  }
+}
+
+/**
+ * Measures the time for running (up to) `ops` tasks on an executor of type E w/ `threads` workers,
+ * either as a binary tree of tasks joining their children (`fork-join`) or as `ops` independent
+ * tasks spawned by a single task (`fan-out`), which spills tasks to the global queue for others.
+ */
+template <typename E>
+executor_sample_t run_executor(
+    const std::string& name,
+    const std::string& workload,
+    std::size_t threads,
+    std::size_t run,
+    std::size_t ops
+) {
+  E executor{ threads };
+  std::atomic_bool done{ false };
+  std::atomic<std::size_t> remaining{ ops };
+  std::size_t tasks = ops;
+
+  const auto start = std::chrono::steady_clock::now();
+  if (workload == "fork-join") {
+    // a tree of depth d consists of 2^(d+1) - 1 tasks
+    const auto depth = std::max<std::size_t>(std::bit_width(ops), 2) - 2;
+    tasks = (std::size_t{ 2 } << depth) - 1;
+    executor.submit([&executor, depth, &done] { fork_join(executor, depth, nullptr, done); });
+  } else {
+    executor.submit([&] {
+      for (std::size_t task = 0; task < ops; ++task) {
+        executor.submit([&] {
+          if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            done.store(true, std::memory_order_release);
+            done.notify_one();
+          }
+        });
+      }
+    });
+  }
+
+  done.wait(false, std::memory_order_acquire);
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+  return { name, workload, threads, run, tasks, seconds.count() };
+}
+
+/** type-erased executor runner for a specific executor type */
+using executor_runner_t = std::function<
+    executor_sample_t(const std::string&, const std::string&, std::size_t, std::size_t, std::size_t)
+>;
+
+/** returns the index of the event with the given name, if it is counted */
+inline std::optional<std::size_t> find_event(
+    const std::vector<perf_event_t>& events,
+    const std::string& name
+) {
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    if (events[i].name == name) {
+      return i;
+    }
+  }
+
+  return std::nullopt;
+}
+
+/** returns the events counted for each worker thread according to `cfg` (w/o duplicates) */
+inline std::vector<perf_event_t> configured_events(const config_t& cfg) {
+  std::vector<perf_event_t> events{};
+  auto add = [&events](const std::vector<perf_event_t>& more) {
+    for (const auto& event : more) {
+      if (!find_event(events, event.name)) {
+        events.push_back(event);
+      }
+    }
+  };
+
+  if (cfg.perf) {
+    add(hardware_events());
+  }
+
+  if (cfg.dtlb) {
+    add(dtlb_events());
+  }
+
+  return events;
+}
+
+/** returns the fraction of dTLB loads that missed, if both events are counted and available */
+inline std::optional<double> dtlb_miss_rate(
+    const sample_t& sample,
+    const std::vector<perf_event_t>& events
+) {
+  const auto loads_idx = find_event(events, "dtlb_loads");
+  const auto misses_idx = find_event(events, "dtlb_load_misses");
+  if (!loads_idx || !misses_idx) {
+    return std::nullopt;
+  }
+
+  const auto loads = sample.per_op(*loads_idx);
+  const auto misses = sample.per_op(*misses_idx);
+  if (!loads || !misses) {
+    return std::nullopt;
+  }
+
+  return *loads == 0.0 ? 0.0 : *misses / *loads;
+}
+
+/** writes an optional value (`null`, or nothing for CSV, if it is empty) */
+inline void write_optional(std::ostream& out, const std::optional<double>& value, bool json) {
+  if (value) {
+    out << *value;
+  } else if (json) {
+    out << "null";
+  }
+}
+
+/**
+ * writes all samples in the configured format, including the per-operation count of each event
+ * (empty if unavailable), the dTLB miss rate, if the dTLB events are counted, and the abandoned
+ * slots per operation, if `abandoned` is set
+ */
+inline void write_samples(
+    std::ostream& out,
+    const std::vector<sample_t>& samples,
+    const std::string& format,
+    const std::vector<perf_event_t>& events = {},
+    bool abandoned = false
+) {
+  const auto miss_rate = find_event(events, "dtlb_loads") && find_event(events, "dtlb_load_misses");
+  if (format == "json") {
+    out << "[\n";
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+      const auto& s = samples[i];
+      out << "  { \"queue\": \"" << s.queue << "\", \"workload\": \"" << s.workload
+          << "\", \"threads\": " << s.threads << ", \"producers\": " << s.producers
+          << ", \"consumers\": " << s.consumers << ", \"run\": " << s.run
+          << ", \"ops\": " << s.ops << ", \"seconds\": " << s.seconds
+          << ", \"mops\": " << s.mops();
+      for (std::size_t event = 0; event < events.size(); ++event) {
+        out << ", \"" << events[event].name << "_per_op\": ";
+        write_optional(out, s.per_op(event), true);
+      }
+
+      if (miss_rate) {
+        out << ", \"dtlb_miss_rate\": ";
+        write_optional(out, dtlb_miss_rate(s, events), true);
+      }
+
+      if (abandoned) {
+        out << ", \"abandoned_per_op\": ";
+        write_optional(out, s.abandoned_per_op(), true);
+      }
+
+      out << " }" << (i + 1 < samples.size() ? ",\n" : "\n");
+    }
+    out << "]" << std::endl;
+  } else {
+    out << "queue,workload,threads,producers,consumers,run,ops,seconds,mops";
+    for (const auto& event : events) {
+      out << ',' << event.name << "_per_op";
+    }
+
+    out << (miss_rate ? ",dtlb_miss_rate" : "") << (abandoned ? ",abandoned_per_op\n" : "\n");
+    for (const auto& s : samples) {
+      out << s.queue << ',' << s.workload << ',' << s.threads << ',' << s.producers << ','
+          << s.consumers << ',' << s.run << ',' << s.ops << ',' << s.seconds << ','
+          << s.mops();
+      for (std::size_t event = 0; event < events.size(); ++event) {
+        out << ',';
+        write_optional(out, s.per_op(event), false);
+      }
+
+      if (miss_rate) {
+        out << ',';
+        write_optional(out, dtlb_miss_rate(s, events), false);
+      }
+
+      if (abandoned) {
+        out << ',';
+        write_optional(out, s.abandoned_per_op(), false);
+      }
+
+      out << '\n';
+    }
+    out.flush();
+  }
+}
+
+/** writes all latency distributions in the configured format (skipped configurations are omitted) */
+inline void write_latencies(std::ostream& out, const std::vector<latency_t>& latencies, const std::string& format) {
+  if (format == "json") {
+    out << "[\n";
+    bool first = true;
+    for (const auto& l : latencies) {
+      if (l.ops == 0) {
+        continue;
+      }
+
+      out << (first ? "" : ",\n") << "  { \"queue\": \"" << l.queue << "\", \"threads\": "
+          << l.threads << ", \"consumers\": " << l.consumers << ", \"run\": " << l.run << ", \"ops\": " << l.ops << ", \"p50_ns\": "
+          << l.p50 << ", \"p99_ns\": " << l.p99 << ", \"p99.9_ns\": " << l.p999
+          << ", \"p99.99_ns\": " << l.p9999 << ", \"max_ns\": " << l.max << " }";
+      first = false;
+    }
+    out << "\n]" << std::endl;
+  } else {
+    out << "queue,threads,consumers,run,ops,p50_ns,p99_ns,p99.9_ns,p99.99_ns,max_ns\n";
+    for (const auto& l : latencies) {
+      if (l.ops == 0) {
+        continue;
+      }
+
+      out << l.queue << ',' << l.threads << ',' << l.consumers << ',' << l.run << ',' << l.ops << ',' << l.p50 << ','
+          << l.p99 << ',' << l.p999 << ',' << l.p9999 << ',' << l.max << '\n';
+    }
+    out.flush();
+  }
+}
+
+/** writes all executor samples in the configured format */
+inline void write_executor_samples(
+    std::ostream& out,
+    const std::vector<executor_sample_t>& samples,
+    const std::string& format
+) {
+  const auto mtasks = [](const executor_sample_t& s) { return double(s.tasks) / s.seconds / 1e6; };
+  if (format == "json") {
+    out << "[\n";
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+      const auto& s = samples[i];
+      out << "  { \"executor\": \"" << s.executor << "\", \"workload\": \"" << s.workload
+          << "\", \"threads\": " << s.threads << ", \"run\": " << s.run << ", \"tasks\": "
+          << s.tasks << ", \"seconds\": " << s.seconds << ", \"mtasks_per_s\": " << mtasks(s)
+          << " }" << (i + 1 < samples.size() ? ",\n" : "\n");
+    }
+    out << "]" << std::endl;
+  } else {
+    out << "executor,workload,threads,run,tasks,seconds,mtasks_per_s\n";
+    for (const auto& s : samples) {
+      out << s.executor << ',' << s.workload << ',' << s.threads << ',' << s.run << ',' << s.tasks
+          << ',' << s.seconds << ',' << mtasks(s) << '\n';
+    }
+    out.flush();
+  }
+}
+
+/** writes all rank errors in the configured format */
+inline void write_rank_errors(std::ostream& out, const std::vector<rank_error_t>& errors, const std::string& format) {
+  if (format == "json") {
+    out << "[\n";
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+      const auto& e = errors[i];
+      out << "  { \"queue\": \"" << e.queue << "\", \"run\": " << e.run << ", \"ops\": " << e.ops
+          << ", \"prefill\": " << e.prefill << ", \"mean_rank_error\": " << e.mean
+          << ", \"max_rank_error\": " << e.max << " }" << (i + 1 < errors.size() ? ",\n" : "\n");
+    }
+    out << "]" << std::endl;
+  } else {
+    out << "queue,run,ops,prefill,mean_rank_error,max_rank_error\n";
+    for (const auto& e : errors) {
+      out << e.queue << ',' << e.run << ',' << e.ops << ',' << e.prefill << ',' << e.mean << ','
+          << e.max << '\n';
+    }
+    out.flush();
+  }
+}
+}
+
+#endif /* LOO_BENCH_HARNESS_HPP */
@@ -0,0 +1,208 @@
+#ifndef LOO_BENCH_PERF_HPP
+#define LOO_BENCH_PERF_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+/** a hardware event, which is counted through `perf_event_open` (Linux only) */
+struct perf_event_t {
+  std::string   name;
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+/** returns the hardware cache event config for the given cache, operation and result */
+constexpr std::uint64_t cache_event(std::uint64_t cache, std::uint64_t op, std::uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+/** the data TLB loads and load misses, which determine the dTLB miss rate */
+inline std::vector<perf_event_t> dtlb_events() {
+#if defined(__linux__)
+  return {
+      { "dtlb_loads", PERF_TYPE_HW_CACHE, cache_event(
+          PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_ACCESS
+      ) },
+      { "dtlb_load_misses", PERF_TYPE_HW_CACHE, cache_event(
+          PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS
+      ) },
+  };
+#else
+  return { { "dtlb_loads", 0, 0 }, { "dtlb_load_misses", 0, 0 } };
+#endif
+}
+
+/**
+ * The events for attributing the cost of each operation: cycles and instructions, L1d load misses
+ * (mostly cache line transfers, e.g., of the head and tail), LLC misses (e.g., of slots in cold
+ * nodes), dTLB load misses and branch misses
+ */
+inline std::vector<perf_event_t> hardware_events() {
+#if defined(__linux__)
+  return {
+      { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+      { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+      { "l1d_load_misses", PERF_TYPE_HW_CACHE, cache_event(
+          PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS
+      ) },
+      { "llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+      { "dtlb_load_misses", PERF_TYPE_HW_CACHE, cache_event(
+          PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS
+      ) },
+      { "branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  };
+#else
+  return {
+      { "cycles", 0, 0 }, { "instructions", 0, 0 }, { "l1d_load_misses", 0, 0 },
+      { "llc_misses", 0, 0 }, { "dtlb_load_misses", 0, 0 }, { "branch_misses", 0, 0 },
+  };
+#endif
+}
+
+/**
+ * Counters for a set of events, which count (user space) events of the calling thread only.
+ *
+ * Each counter, which can not be opened (e.g., in containers or VMs w/o access to the PMU or on
+ * other platforms) is unavailable, so its value is empty.
+ * Counters are scaled by the fraction of time they were actually scheduled, if the kernel had to
+ * multiplex more events than there are hardware counters.
+ */
+class perf_counters_t {
+public:
+  /** constructor (opens one counter per event for the calling thread, initially disabled) */
+  explicit perf_counters_t(const std::vector<perf_event_t>& events) {
+    this->m_fds.reserve(events.size());
+    for (const auto& event : events) {
+      this->m_fds.push_back(open_counter(event));
+    }
+  }
+
+  /** destructor */
+  ~perf_counters_t() noexcept {
+#if defined(__linux__)
+    for (const auto fd : this->m_fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  /** resets and enables all counters */
+  void start() noexcept {
+#if defined(__linux__)
+    for (const auto fd : this->m_fds) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  /** disables all counters */
+  void stop() noexcept {
+#if defined(__linux__)
+    for (const auto fd : this->m_fds) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      }
+    }
+#endif
+  }
+
+  /** returns the (scaled) values of all counters, empty for unavailable counters */
+  [[nodiscard]] std::vector<std::optional<double>> read() const {
+    std::vector<std::optional<double>> res(this->m_fds.size());
+#if defined(__linux__)
+    for (std::size_t i = 0; i < this->m_fds.size(); ++i) {
+      // value, time enabled, time running (see PERF_FORMAT_TOTAL_TIME_*)
+      std::uint64_t values[3]{};
+      if (this->m_fds[i] < 0 || ::read(this->m_fds[i], values, sizeof(values)) != sizeof(values)) {
+        continue;
+      }
+
+      res[i] = values[2] == 0
+          ? 0.0
+          : double(values[0]) * double(values[1]) / double(values[2]);
+    }
+#endif
+    return res;
+  }
+
+  /** deleted constructors & assignment operators */
+  perf_counters_t(const perf_counters_t&)            = delete;
+  perf_counters_t& operator=(const perf_counters_t&) = delete;
+
+private:
+  static int open_counter(const perf_event_t& event) noexcept {
+#if defined(__linux__) && defined(SYS_perf_event_open)
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // pid = 0 & cpu = -1: the calling thread on any CPU
+    return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+    (void) event;
+    return -1;
+#endif
+  }
+
+  std::vector<int> m_fds{};
+};
+
+/** returns the names of all events, which can not be counted for the calling thread */
+inline std::vector<std::string> unavailable_events(const std::vector<perf_event_t>& events) {
+  perf_counters_t counters{ events };
+  counters.start();
+  counters.stop();
+
+  std::vector<std::string> res{};
+  const auto counts = counters.read();
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    if (!counts[i]) {
+      res.push_back(events[i].name);
+    }
+  }
+
+  return res;
+}
+
+/** the sums of each event's counts over all threads (empty if unavailable for any thread) */
+struct perf_totals_t {
+  std::vector<std::optional<double>> counts{};
+
+  /** adds the counts of a single thread */
+  void add(const std::vector<std::optional<double>>& thread_counts) {
+    if (this->counts.empty()) {
+      this->counts = thread_counts;
+      return;
+    }
+
+    for (std::size_t i = 0; i < this->counts.size(); ++i) {
+      if (this->counts[i] && thread_counts[i]) {
+        *this->counts[i] += *thread_counts[i];
+      } else {
+        this->counts[i].reset();
+      }
+    }
+  }
+};
+}
+
+#endif /* LOO_BENCH_PERF_HPP */
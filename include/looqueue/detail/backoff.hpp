@@ -0,0 +1,48 @@
+#ifndef LOO_QUEUE_BACKOFF_HPP
+#define LOO_QUEUE_BACKOFF_HPP
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+namespace loo::detail {
+/** hints the processor that the calling thread is spinning */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_AMD64)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+/** spins for exponentially increasing numbers of iterations (up to `max_spins`) */
+class exponential_backoff {
+public:
+  /** constructor */
+  explicit exponential_backoff(std::uint32_t max_spins) noexcept : m_max_spins{ max_spins } {}
+
+  /** spins for the current number of iterations and doubles it */
+  void spin() noexcept {
+    for (std::uint32_t spin = 0; spin < this->m_spins; ++spin) {
+      cpu_relax();
+    }
+
+    if (this->m_spins < this->m_max_spins) {
+      this->m_spins *= 2;
+    }
+  }
+
+  /** restarts w/ a single iteration */
+  void reset() noexcept {
+    this->m_spins = 1;
+  }
+
+private:
+  std::uint32_t m_spins{ 1 };
+  std::uint32_t m_max_spins;
+};
+}
+
+#endif /* LOO_QUEUE_BACKOFF_HPP */
@@ -0,0 +1,50 @@
+#ifndef LOO_QUEUE_DEQUEUE_AWAITABLE_HPP
+#define LOO_QUEUE_DEQUEUE_AWAITABLE_HPP
+
+#include <coroutine>
+
+#include "looqueue/queue_fwd.hpp"
+
+namespace loo {
+template <typename T, std::size_t NodeSize, typename... Policies>
+template <coroutine_executor Executor>
+class queue<T, NodeSize, Policies...>::dequeue_awaitable : private async_waiter_t {
+public:
+  /** constructor */
+  dequeue_awaitable(queue& queue, Executor& executor) : m_queue{ queue }, m_executor{ executor } {
+    this->schedule = &dequeue_awaitable::schedule_on_executor;
+  }
+
+  /** attempts to dequeue an element without suspending */
+  bool await_ready() {
+    this->result = this->m_queue.dequeue();
+    return codec_t::has_value(this->result);
+  }
+
+  /** registers the suspended coroutine, which is resumed once an element is handed to it */
+  void await_suspend(std::coroutine_handle<> handle) {
+    this->handle = handle;
+    // the awaitable may be destroyed by a concurrent resumption as soon as it is registered
+    auto& queue = this->m_queue;
+    queue.suspend_async_waiter(this);
+  }
+
+  /** returns the dequeued element */
+  value_type await_resume() {
+    return codec_t::unwrap(this->result);
+  }
+
+private:
+  static void schedule_on_executor(async_waiter_t* waiter) {
+    auto& self = static_cast<dequeue_awaitable&>(*waiter);
+    // the coroutine (and hence the awaitable) may be destroyed once it is scheduled
+    auto& executor = self.m_executor;
+    executor.execute(self.handle);
+  }
+
+  queue&    m_queue;
+  Executor& m_executor;
+};
+}
+
+#endif /* LOO_QUEUE_DEQUEUE_AWAITABLE_HPP */
@@ -0,0 +1,62 @@
+#ifndef LOO_QUEUE_EVENT_COUNT_HPP
+#define LOO_QUEUE_EVENT_COUNT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "looqueue/detail/futex.hpp"
+
+namespace loo::detail {
+/**
+ * An event count for parking threads waiting on a lock-free data structure.
+ *
+ * A waiting thread calls `prepare_wait`, re-checks its wait condition and then either calls
+ * `cancel_wait` or `wait` with the returned key.
+ * A notifying thread calls `notify` after making the condition true, which costs only a fence and
+ * a load (of a rarely written variable), unless there are any waiting threads.
+ * The fences in `prepare_wait` and `notify` ensure that either the waiting thread observes the
+ * notifier's modifications in its re-check or the notifier observes the incremented waiters count.
+ */
+class event_count {
+public:
+  /** announces the calling thread as waiter and returns the key for the subsequent `wait` */
+  std::uint32_t prepare_wait() {
+    this->m_waiters.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return this->m_epoch.load(std::memory_order_acquire);
+  }
+
+  /** withdraws the calling thread as waiter (its wait condition has become true) */
+  void cancel_wait() {
+    this->m_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * blocks until woken up by `notify` after `prepare_wait` returned `key`, `timeout` expires (if
+   * not null, returns false) or spuriously
+   */
+  bool wait(std::uint32_t key, const std::chrono::nanoseconds* timeout = nullptr) {
+    const auto res = futex_wait(this->m_epoch, key, timeout);
+    this->m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return res;
+  }
+
+  /** wakes up to `count` waiting threads, if there are any */
+  void notify(std::uint32_t count = 1) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->m_waiters.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+      this->m_epoch.fetch_add(1, std::memory_order_release);
+      futex_wake(this->m_epoch, count);
+    }
+  }
+
+private:
+  /** the number of threads currently (preparing to be) waiting */
+  std::atomic_uint32_t m_waiters{ 0 };
+  /** incremented by every notification with waiting threads */
+  std::atomic_uint32_t m_epoch{ 0 };
+};
+}
+
+#endif /* LOO_QUEUE_EVENT_COUNT_HPP */
@@ -0,0 +1,77 @@
+#ifndef LOO_QUEUE_FUTEX_HPP
+#define LOO_QUEUE_FUTEX_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace loo::detail {
+static_assert(sizeof(std::atomic_uint32_t) == sizeof(std::uint32_t));
+
+/**
+ * Blocks the calling thread as long as `word` contains `expected`, until it is woken up by
+ * `futex_wake` or `timeout` (if not null) has expired, returns false only in the latter case.
+ *
+ * Spurious wake-ups are possible, so callers must re-check their wait condition.
+ */
+inline bool futex_wait(
+    std::atomic_uint32_t& word,
+    std::uint32_t expected,
+    const std::chrono::nanoseconds* timeout
+) {
+#if defined(__linux__)
+  timespec ts{ };
+  if (timeout != nullptr) {
+    ts.tv_sec  = static_cast<std::time_t>(timeout->count() / 1'000'000'000);
+    ts.tv_nsec = static_cast<long>(timeout->count() % 1'000'000'000);
+  }
+
+  const auto res = syscall(
+      SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected,
+      timeout != nullptr ? &ts : nullptr, nullptr, 0
+  );
+
+  return res == 0 || errno != ETIMEDOUT;
+#else
+  if (timeout == nullptr) {
+    word.wait(expected, std::memory_order_acquire);
+    return true;
+  }
+
+  // there is no portable timed wait on atomic variables, so sleep for a short period instead,
+  // which appears as a spurious wake-up to the caller, unless the entire timeout has expired
+  const auto period = std::min(*timeout, std::chrono::nanoseconds{ 50'000 });
+  std::this_thread::sleep_for(period);
+  return period < *timeout;
+#endif
+}
+
+/** wakes up to `count` threads blocked in `futex_wait` on `word` */
+inline void futex_wake(std::atomic_uint32_t& word, std::uint32_t count) {
+#if defined(__linux__)
+  syscall(
+      SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE,
+      static_cast<int>(std::min<std::uint32_t>(count, INT32_MAX)), nullptr, nullptr, 0
+  );
+#else
+  if (count == 1) {
+    word.notify_one();
+  } else {
+    word.notify_all();
+  }
+#endif
+}
+}
+
+#endif /* LOO_QUEUE_FUTEX_HPP */
@@ -14,6 +14,8 @@ public:
   static constexpr std::uintptr_t TAG_BITS = N;
   static constexpr std::uintptr_t TAG_MASK = (std::uintptr_t{ 1 } << TAG_BITS) - std::uintptr_t{ 1 };
   static constexpr std::uintptr_t PTR_MASK = ~TAG_MASK;
+  /** the value to add to the underlying integer for incrementing the tag by one */
+  static constexpr std::uintptr_t INCREMENT = 1;
 
   struct decomposed_t {
     pointer  ptr;
@@ -27,6 +29,11 @@ public:
   explicit marked_ptr_t(pointer ptr, tag_type idx) :
       marked_ptr_t(reinterpret_cast<std::uintptr_t>(ptr) | idx) {}
 
+  /** returns true if `ptr` has none of the tag bits set */
+  static bool is_valid(pointer ptr) {
+    return (reinterpret_cast<std::uintptr_t>(ptr) & TAG_MASK) == 0;
+  }
+
   decomposed_t decompose() const {
     return { this->decompose_ptr(), this->decompose_tag() };
   }
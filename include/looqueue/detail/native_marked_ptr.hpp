@@ -5,17 +5,23 @@
 #include <utility>
 
 namespace loo::detail {
+/**
+ * A pointer storing an N bit tag in its (unused) high bits, which requires all pointer values to
+ * fit into the remaining 64 - N bits.
+ */
 template <typename T, std::uint8_t N>
 class native_marked_ptr_t final {
-  static_assert(N <= 9, "only up to 16 tag bits allowed");
+  static_assert(N > 0 && N <= 16, "only up to 16 tag bits allowed");
 public:
   using pointer  = T*;
-  using tag_type = std::uint64_t;
+  using tag_type = std::uintptr_t;
 
-  static constexpr std::uint64_t TAG_SHIFT = 55;
-  static constexpr std::uint64_t TAG_MASK  = 0x1FFull << TAG_SHIFT;
-  static constexpr std::uint64_t PTR_MASK  = ~TAG_MASK;
-  static constexpr std::uint64_t INCREMENT = 1ull << TAG_SHIFT;
+  static constexpr std::uintptr_t TAG_BITS  = N;
+  static constexpr std::uintptr_t TAG_SHIFT = 64 - TAG_BITS;
+  static constexpr std::uintptr_t TAG_MASK  = ((std::uintptr_t{ 1 } << TAG_BITS) - 1) << TAG_SHIFT;
+  static constexpr std::uintptr_t PTR_MASK  = ~TAG_MASK;
+  /** the value to add to the underlying integer for incrementing the tag by one */
+  static constexpr std::uintptr_t INCREMENT = std::uintptr_t{ 1 } << TAG_SHIFT;
 
   struct decomposed_t {
     pointer  ptr;
@@ -25,9 +31,14 @@ public:
   /** constructor (default) */
   native_marked_ptr_t() = default;
   /** constructor(s) */
-  explicit native_marked_ptr_t(std::uint64_t marked) : m_marked{ marked } {}
+  explicit native_marked_ptr_t(std::uintptr_t marked) : m_marked{ marked } {}
   explicit native_marked_ptr_t(pointer ptr, tag_type idx) :
-      native_marked_ptr_t(idx << TAG_SHIFT | reinterpret_cast<std::uint64_t>(ptr)) {}
+      native_marked_ptr_t(idx << TAG_SHIFT | reinterpret_cast<std::uintptr_t>(ptr)) {}
+
+  /** returns true if `ptr` has none of the tag bits set */
+  static bool is_valid(pointer ptr) {
+    return (reinterpret_cast<std::uintptr_t>(ptr) & TAG_MASK) == 0;
+  }
 
   decomposed_t decompose() const {
     return { this->decompose_ptr(), this->decompose_tag() };
@@ -37,17 +48,17 @@ public:
     return reinterpret_cast<pointer>(this->m_marked & PTR_MASK);
   }
 
-  tag_type decompose_tag() const {
+  [[nodiscard]] tag_type decompose_tag() const {
     return m_marked >> TAG_SHIFT;
   }
 
   /** returns the underlying integer value */
-  std::uint64_t to_int() const {
+  [[nodiscard]] std::uintptr_t to_uintptr() const {
     return this->m_marked;
   }
 
   /** returns a reference to the underlying integer value */
-  std::uint64_t& as_int() {
+  std::uintptr_t& as_uintptr() {
     return this->m_marked;
   }
 
@@ -56,7 +67,7 @@ public:
   }
 
 private:
-  std::uint64_t m_marked{ 0 };
+  std::uintptr_t m_marked{ 0 };
 };
 }
 
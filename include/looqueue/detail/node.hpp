@@ -1,17 +1,17 @@
 #ifndef LOO_QUEUE_NODE_HPP
 #define LOO_QUEUE_NODE_HPP
 
-#include <array>
 #include <atomic>
 #include <cassert>
 #include <limits>
+#include <new>
 
 #include "looqueue/queue_fwd.hpp"
+#include "looqueue/detail/trace.hpp"
 
 namespace loo {
-template <typename T>
-struct queue<T>::node_t {
-  using slot_array_t = std::array<atomic_slot_t, NODE_SIZE>;
+template <typename T, std::size_t NodeSize, typename... Policies>
+struct queue<T, NodeSize, Policies...>::node_t {
   /** the control block for managing safe memory reclamation */
   struct ctrl_block_t {
     /** high 16 bits: final observed count of slow-path enqueue ops, low 16 bits: current count */
@@ -24,12 +24,15 @@ struct queue<T>::node_t {
 
   /** struct members */
 
+  /** the queue which allocated the node and to which it is returned once reclaimed */
+  const typename addressing_t::template pointer_t<queue> owner;
   /** control block for memory reclamation */
   ctrl_block_t ctrl{ };
+  /** the number of slots (always NODE_SIZE unless nodes grow) */
+  const std::uint32_t capacity;
   /** pointer to successor node */
-  std::atomic<node_t*> next{ nullptr };
-  /** array of individual slots for storing elements + state bits */
-  slot_array_t slots{ };
+  atomic_ptr_t<node_t> next{ nullptr };
+  // the array of individual slots for storing elements + state bits follows the node (see `slots`)
 
   /** slot flag constants */
   enum slot_flags_t : std::uintptr_t {
@@ -60,7 +63,7 @@ struct queue<T>::node_t {
   /** returns true if a slot has been either consumed or abandoned */
   static constexpr auto is_consumed(slot_t slot) {
     if ((slot & slot_flags_t::ELEM_MASK) == 0 ) {
-      // there are no pointer (elem) bits set, so no writer has visited the slot yet
+      // there are no element bits set, so no writer has visited the slot yet
       return false;
     }
 
@@ -68,29 +71,59 @@ struct queue<T>::node_t {
     return (slot & slot_flags_t::READER) == slot_flags_t::READER;
   }
 
-  /** constructor (default) */
-  node_t() {
-    for (auto& slot : this->slots) {
-      slot.store(slot_flags_t::UNINIT, relaxed);
+  /** returns the number of bytes required for a node w/ `size` slots */
+  static constexpr std::size_t bytes(std::size_t size) noexcept {
+    return sizeof(node_t) + size * sizeof(atomic_slot_t);
+  }
+
+  /** constructor (the node must be allocated w/ `bytes(size)` bytes) */
+  explicit node_t(queue* owner, std::size_t size) :
+    owner{ owner },
+    capacity{ static_cast<std::uint32_t>(size) }
+  {
+    for (std::size_t idx = 0; idx < this->size(); ++idx) {
+      new(&this->slots()[idx]) atomic_slot_t{ slot_flags_t::UNINIT };
     }
   };
 
-  /** constructor w/ tentative first element */
-  explicit node_t(pointer first) : node_t() {
-    this->slots[0].store(reinterpret_cast<slot_t>(first), relaxed);
+  /** constructor w/ tentative first (encoded) element */
+  explicit node_t(queue* owner, std::size_t size, slot_t first) : node_t(owner, size) {
+    this->slots()[0].store(first, relaxed);
+  }
+
+  /** returns the number of slots */
+  [[nodiscard]] std::size_t size() const noexcept {
+    if constexpr (GROWING) {
+      return this->capacity;
+    } else {
+      return NODE_SIZE;
+    }
+  }
+
+  /** returns the array of slots, which directly follows the node */
+  [[nodiscard]] atomic_slot_t* slots() noexcept {
+    return reinterpret_cast<atomic_slot_t*>(this + 1);
   }
 
   /** checks if all slots are consumed before attempting reclamation */
   void try_reclaim(std::uint64_t start_idx) {
+    // a start index other than 0 means the checks are resumed by a slot's final visitor
+    LOO_TRACE(reclaim_scan, this, start_idx);
     // iterate all slots beginning at `start_idx`
-    for (std::uint64_t idx = start_idx; idx < NODE_SIZE; ++idx) {
-      auto& slot = this->slots[idx];
+    for (std::uint64_t idx = start_idx; idx < this->size(); ++idx) {
+      auto& slot = this->slots()[idx];
       if (!is_consumed(slot.load(acquire))) {
         // if the current slot has not already been consumed, set the RESUME bit, check again
         // and abort the iteration if it has still not been consumed
         // once the consuming thread(s) eventually arrive they will observe the RESUME bit and
         // the thread arriving last will resume the procedure from the following slot on
-        if (!is_consumed(slot.fetch_add(slot_flags_t::RESUME, relaxed))) {
+        // the owner is loaded before the node may be reclaimed by the slot's final visitor, so the
+        // RMW must be a release to keep the load from being re-ordered past it
+        queue* const owner = this->owner;
+        if (!is_consumed(slot.fetch_add(slot_flags_t::RESUME, release))) {
+          // the node may already have been reclaimed by the slot's final visitor at this point
+          owner->m_stats.increment(queue_event::RECLAIM_HANDOFF);
+          LOO_TRACE(reclaim_handoff, this, idx);
           return;
         }
       }
@@ -101,7 +134,8 @@ struct queue<T>::node_t {
     const auto flags = this->ctrl.reclaim_flags.fetch_add(reclaim_flags_t::ARR, acq_rel);
     // if all 3 bits are set after setting the SLOTS bit, the node can be reclaimed
     if (flags == (reclaim_flags_t::ENQ | reclaim_flags_t::DEQ)) {
-      delete this;
+      LOO_TRACE(node_reclaim, this, reclaim_flags_t::ARR);
+      this->owner->reclaim_node(this);
     }
   }
 
@@ -131,6 +165,22 @@ struct queue<T>::node_t {
     this->try_reclaim_post_increment(counts, reclaim_flags_t::DEQ, EXPECTED_FLAGS);
   }
 
+  /**
+   * Sets the ENQ bit directly (`single_producer` only), once the tail has been advanced, since
+   * there are no other (slow-path) enqueue ops that could still access the node.
+   */
+  void finish_enqueues() {
+    this->try_reclaim_post_flag(reclaim_flags_t::ENQ, reclaim_flags_t::ARR | reclaim_flags_t::DEQ);
+  }
+
+  /**
+   * Sets the DEQ bit directly (`single_consumer` only), once the head has been advanced, since
+   * there are no other (slow-path) dequeue ops that could still access the node.
+   */
+  void finish_dequeues() {
+    this->try_reclaim_post_flag(reclaim_flags_t::DEQ, reclaim_flags_t::ARR | reclaim_flags_t::ENQ);
+  }
+
 private:
   struct counts_t {
     std::uint16_t curr_count, final_count;
@@ -172,10 +222,19 @@ private:
       std::uint8_t expected_flags
   ) {
     if (counts.curr_count == counts.final_count) {
-      const auto flags = this->ctrl.reclaim_flags.fetch_add(flag_bit, acq_rel);
-      if (flags == expected_flags) {
-        delete this;
-      }
+      this->try_reclaim_post_flag(flag_bit, expected_flags);
+    }
+  }
+
+  /**
+   * Sets `flag_bit` in this node's reclaim flags and proceeds to de-allocate the node if the
+   * reclaim flags before setting the bit were equal to `expected_flags`.
+   */
+  void try_reclaim_post_flag(std::uint8_t flag_bit, std::uint8_t expected_flags) {
+    const auto flags = this->ctrl.reclaim_flags.fetch_add(flag_bit, acq_rel);
+    if (flags == expected_flags) {
+      LOO_TRACE(node_reclaim, this, flag_bit);
+      this->owner->reclaim_node(this);
     }
   }
 };
@@ -0,0 +1,85 @@
+#ifndef LOO_QUEUE_NUMA_HPP
+#define LOO_QUEUE_NUMA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace loo::detail {
+/** parses a sysfs list (e.g., "0-3,8,10-11") and returns all contained values */
+inline std::vector<std::size_t> parse_sysfs_list(const std::string& list) {
+  std::vector<std::size_t> res{};
+  std::stringstream stream{ list };
+  for (std::string range; std::getline(stream, range, ',');) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+
+    const auto dash = range.find('-');
+    const auto first = std::stoul(range.substr(0, dash));
+    const auto last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+    for (auto value = first; value <= last; ++value) {
+      res.push_back(value);
+    }
+  }
+
+  return res;
+}
+
+/** returns the first line of the file at `path` or an empty string if it can not be read */
+inline std::string read_sysfs_file(const std::string& path) {
+  std::ifstream file{ path };
+  std::string line{};
+  std::getline(file, line);
+  return line;
+}
+
+/** returns the CPU the calling thread is currently running on (0 if unknown) */
+inline std::size_t current_cpu() noexcept {
+#if defined(__linux__)
+  // sched_getcpu is implemented through the vDSO (or rseq), so it is cheap enough to call for every
+  // operation
+  const auto cpu = sched_getcpu();
+  return cpu < 0 ? 0 : std::size_t(cpu);
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Sets the NUMA memory policy of all pages in [addr, addr + len) to prefer `node`, which must be
+ * applied before the pages are first touched; failures (e.g., due to missing kernel support or
+ * permissions) are ignored, since the memory remains usable regardless.
+ */
+inline void mbind_preferred(void* addr, std::size_t len, int node) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+  constexpr auto MPOL_PREFERRED = 1;
+  constexpr auto MASK_BITS = std::size_t{ 1024 };
+  constexpr auto WORD_BITS = 8 * sizeof(unsigned long);
+
+  if (node < 0 || std::size_t(node) >= MASK_BITS) {
+    return;
+  }
+
+  unsigned long mask[MASK_BITS / WORD_BITS]{};
+  mask[std::size_t(node) / WORD_BITS] = 1ul << (std::size_t(node) % WORD_BITS);
+  // the kernel expects the number of mask bits plus one
+  syscall(SYS_mbind, addr, len, MPOL_PREFERRED, mask, MASK_BITS + 1, 0);
+#else
+  (void) addr;
+  (void) len;
+  (void) node;
+#endif
+}
+}
+
+#endif /* LOO_QUEUE_NUMA_HPP */
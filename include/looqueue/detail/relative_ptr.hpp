@@ -0,0 +1,190 @@
+#ifndef LOO_QUEUE_RELATIVE_PTR_HPP
+#define LOO_QUEUE_RELATIVE_PTR_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace loo::detail {
+/** returns the distance of `ptr` from `self` (0 for `nullptr`) */
+inline std::uintptr_t relative_to(const void* self, const void* ptr) noexcept {
+  if (ptr == nullptr) {
+    return 0;
+  }
+
+  return reinterpret_cast<std::uintptr_t>(ptr) - reinterpret_cast<std::uintptr_t>(self);
+}
+
+/** returns the pointer at distance `diff` from `self` (`nullptr` for 0) */
+template <typename T>
+T* absolute_from(const void* self, std::uintptr_t diff) noexcept {
+  if (diff == 0) {
+    return nullptr;
+  }
+
+  return reinterpret_cast<T*>(reinterpret_cast<std::uintptr_t>(self) + diff);
+}
+
+/**
+ * A pointer stored as its distance from its own address, which remains valid in every process
+ * mapping the (shared memory) segment containing both the pointer and its target, so it must never
+ * be copied and must never point at itself.
+ */
+template <typename T>
+class relative_ptr_t final {
+public:
+  /** constructor(s) */
+  explicit relative_ptr_t(T* ptr = nullptr) noexcept : m_diff{ relative_to(this, ptr) } {}
+
+  relative_ptr_t& operator=(T* ptr) noexcept {
+    this->m_diff = relative_to(this, ptr);
+    return *this;
+  }
+
+  /** returns the pointer in the calling process' mapping */
+  operator T*() const noexcept {
+    return absolute_from<T>(this, this->m_diff);
+  }
+
+  T* operator->() const noexcept {
+    return *this;
+  }
+
+  /** deleted constructors & assignment operators */
+  relative_ptr_t(const relative_ptr_t&)            = delete;
+  relative_ptr_t& operator=(const relative_ptr_t&) = delete;
+
+private:
+  std::uintptr_t m_diff;
+};
+
+/**
+ * An atomic `relative_ptr_t`, whose operations take and return pointers in the calling process'
+ * mapping just like those of `std::atomic<T*>`.
+ */
+template <typename T>
+class atomic_relative_ptr_t final {
+public:
+  /** constructor(s) */
+  explicit atomic_relative_ptr_t(T* ptr = nullptr) noexcept : m_diff{ relative_to(this, ptr) } {}
+
+  T* load(std::memory_order order) const noexcept {
+    return absolute_from<T>(this, this->m_diff.load(order));
+  }
+
+  void store(T* ptr, std::memory_order order) noexcept {
+    this->m_diff.store(relative_to(this, ptr), order);
+  }
+
+  T* exchange(T* ptr, std::memory_order order) noexcept {
+    return absolute_from<T>(this, this->m_diff.exchange(relative_to(this, ptr), order));
+  }
+
+  bool compare_exchange_strong(
+      T*&               expected,
+      T*                desired,
+      std::memory_order success,
+      std::memory_order failure
+  ) noexcept {
+    auto diff = relative_to(this, expected);
+    if (this->m_diff.compare_exchange_strong(diff, relative_to(this, desired), success, failure)) {
+      return true;
+    }
+
+    expected = absolute_from<T>(this, diff);
+    return false;
+  }
+
+  /** deleted constructors & assignment operators */
+  atomic_relative_ptr_t(const atomic_relative_ptr_t&)            = delete;
+  atomic_relative_ptr_t& operator=(const atomic_relative_ptr_t&) = delete;
+
+private:
+  std::atomic<std::uintptr_t> m_diff;
+};
+
+/**
+ * An atomic (node pointer, index) pair (see `native_marked_ptr_t`), whose pointer bits are stored
+ * as their distance from the pair's own address (modulo the pointer bits, so the tag bits are never
+ * affected), all operations take and return the pair w/ the pointer in the calling process' mapping
+ * just like those of `std::atomic<std::uintptr_t>`, but `fetch_add` must only add to the tag bits.
+ */
+template <typename MarkedPtr>
+class atomic_relative_marked_t final {
+  static constexpr std::uintptr_t PTR_MASK = MarkedPtr::PTR_MASK;
+  static_assert(
+      std::has_single_bit(PTR_MASK + 1),
+      "relative (node pointer, index) pairs require the index in the high bits (high_bit_tagging)"
+  );
+
+public:
+  /** constructor(s) */
+  explicit atomic_relative_marked_t(std::uintptr_t marked = 0) noexcept :
+    m_marked{ this->to_relative(marked) } {}
+
+  std::uintptr_t load(std::memory_order order) const noexcept {
+    return this->to_absolute(this->m_marked.load(order));
+  }
+
+  void store(std::uintptr_t marked, std::memory_order order) noexcept {
+    this->m_marked.store(this->to_relative(marked), order);
+  }
+
+  std::uintptr_t fetch_add(std::uintptr_t add, std::memory_order order) noexcept {
+    return this->to_absolute(this->m_marked.fetch_add(add, order));
+  }
+
+  bool compare_exchange_weak(
+      std::uintptr_t&   expected,
+      std::uintptr_t    desired,
+      std::memory_order success,
+      std::memory_order failure
+  ) noexcept {
+    auto relative = this->to_relative(expected);
+    const auto replace = this->to_relative(desired);
+    if (this->m_marked.compare_exchange_weak(relative, replace, success, failure)) {
+      return true;
+    }
+
+    expected = this->to_absolute(relative);
+    return false;
+  }
+
+  bool compare_exchange_strong(
+      std::uintptr_t&   expected,
+      std::uintptr_t    desired,
+      std::memory_order success,
+      std::memory_order failure
+  ) noexcept {
+    auto relative = this->to_relative(expected);
+    const auto replace = this->to_relative(desired);
+    if (this->m_marked.compare_exchange_strong(relative, replace, success, failure)) {
+      return true;
+    }
+
+    expected = this->to_absolute(relative);
+    return false;
+  }
+
+  /** deleted constructors & assignment operators */
+  atomic_relative_marked_t(const atomic_relative_marked_t&)            = delete;
+  atomic_relative_marked_t& operator=(const atomic_relative_marked_t&) = delete;
+
+private:
+  [[nodiscard]] std::uintptr_t self() const noexcept {
+    return reinterpret_cast<std::uintptr_t>(this);
+  }
+
+  [[nodiscard]] std::uintptr_t to_relative(std::uintptr_t marked) const noexcept {
+    return (marked & ~PTR_MASK) | ((marked - this->self()) & PTR_MASK);
+  }
+
+  [[nodiscard]] std::uintptr_t to_absolute(std::uintptr_t marked) const noexcept {
+    return (marked & ~PTR_MASK) | ((marked + this->self()) & PTR_MASK);
+  }
+
+  std::atomic<std::uintptr_t> m_marked;
+};
+}
+
+#endif /* LOO_QUEUE_RELATIVE_PTR_HPP */
@@ -0,0 +1,129 @@
+#ifndef LOO_QUEUE_SLOT_CODEC_HPP
+#define LOO_QUEUE_SLOT_CODEC_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+namespace loo::detail {
+/** marker type selecting the value encoding for `loo::value_queue` */
+template <typename V>
+struct by_value {};
+
+/**
+ * Encodes elements of type `T*` into slots and back.
+ *
+ * The 2 lowest bits of every slot are reserved for the RESUME and READER state bits, all other
+ * bits are the element bits, at least one of which must be set once an element has been written to
+ * the slot.
+ * Non-null pointers with at least 4 byte alignment fulfill this as-is.
+ */
+template <typename T>
+struct slot_codec {
+  static_assert(sizeof(T*) == 8, "loo::queue is only valid for 64-bit architectures");
+  static_assert(alignof(T) >= 4, "all T pointers must be at least 4-byte aligned");
+
+  /** the type of enqueued elements */
+  using value_type  = T*;
+  /** the type of dequeued elements, `nullptr` if the queue is empty */
+  using result_type = T*;
+
+  /** validates `elem` and throws if it is invalid */
+  static void validate(value_type elem) {
+    if (elem == nullptr) [[unlikely]] {
+      throw std::invalid_argument("enqueue element must not be null");
+    }
+  }
+
+  static std::uintptr_t encode(value_type elem) noexcept {
+    return reinterpret_cast<std::uintptr_t>(elem);
+  }
+
+  /** decodes the (masked) element bits of a slot */
+  static value_type decode(std::uintptr_t bits) noexcept {
+    return reinterpret_cast<value_type>(bits);
+  }
+
+  static result_type empty() noexcept {
+    return nullptr;
+  }
+
+  static bool has_value(result_type res) noexcept {
+    return res != nullptr;
+  }
+
+  static value_type unwrap(result_type res) noexcept {
+    return res;
+  }
+};
+
+/**
+ * Encodes values of any trivially copyable type `V` of up to 8 bytes into slots and back.
+ *
+ * The value's object representation is incremented by one and shifted past the 2 state bits, so
+ * that a zero value is still distinguishable from an uninitialized slot.
+ * All types with less than 8 bytes therefore fit without restrictions, 8 byte values must not
+ * exceed `MAX_BITS`.
+ */
+template <typename V>
+struct slot_codec<by_value<V>> {
+  static_assert(sizeof(std::uintptr_t) == 8, "loo::queue is only valid for 64-bit architectures");
+  static_assert(std::is_trivially_copyable_v<V>, "V must be trivially copyable");
+  static_assert(sizeof(V) <= sizeof(std::uint64_t), "V must not be larger than 8 bytes");
+  static_assert(std::endian::native == std::endian::little, "V must be stored in the low bits");
+
+  /** the type of enqueued elements */
+  using value_type  = V;
+  /** the type of dequeued elements, empty if the queue is empty */
+  using result_type = std::optional<V>;
+
+  /** the largest encodable object representation of a value (62 bits) */
+  static constexpr std::uint64_t MAX_BITS = (std::uint64_t{ 1 } << 62) - 2;
+
+  /** validates `elem` and throws if it is invalid */
+  static void validate(const value_type& elem) {
+    if constexpr (sizeof(V) == sizeof(std::uint64_t)) {
+      if (to_bits(elem) > MAX_BITS) [[unlikely]] {
+        throw std::invalid_argument("enqueue value must not exceed 62 bits");
+      }
+    }
+  }
+
+  static std::uintptr_t encode(const value_type& elem) noexcept {
+    return (to_bits(elem) + 1) << 2;
+  }
+
+  /** decodes the (masked) element bits of a slot */
+  static value_type decode(std::uintptr_t bits) noexcept {
+    const auto repr = std::uint64_t{ (bits >> 2) - 1 };
+    std::array<unsigned char, sizeof(V)> bytes;
+    std::memcpy(bytes.data(), &repr, sizeof(V));
+    return std::bit_cast<V>(bytes);
+  }
+
+  static result_type empty() noexcept {
+    return std::nullopt;
+  }
+
+  static bool has_value(const result_type& res) noexcept {
+    return res.has_value();
+  }
+
+  static value_type unwrap(const result_type& res) noexcept {
+    return *res;
+  }
+
+private:
+  static std::uint64_t to_bits(const value_type& elem) noexcept {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &elem, sizeof(V));
+    return bits;
+  }
+};
+}
+
+#endif /* LOO_QUEUE_SLOT_CODEC_HPP */
@@ -0,0 +1,29 @@
+#ifndef LOO_QUEUE_TRACE_HPP
+#define LOO_QUEUE_TRACE_HPP
+
+/**
+ * Static tracepoints (USDT probes of the `looqueue` provider) on slow-path and reclamation events.
+ *
+ * If `<sys/sdt.h>` is available (e.g., from systemtap-sdt-dev), each `LOO_TRACE(probe, args...)`
+ * compiles to a single nop and an ELF note describing the locations of its arguments, which tools
+ * like bpftrace or perf can attach to at runtime, e.g.:
+ *
+ *   bpftrace -e 'usdt:./app:looqueue:node_reclaim { @[arg1] = count(); }'
+ *
+ * Otherwise, or if `LOO_QUEUE_NO_TRACE` is defined, the probes (and their arguments) are removed
+ * entirely.
+ */
+#if !defined(LOO_QUEUE_NO_TRACE) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define LOO_QUEUE_TRACE_ENABLED 1
+#endif
+#endif
+
+#if defined(LOO_QUEUE_TRACE_ENABLED)
+#define LOO_TRACE(probe, ...) STAP_PROBEV(looqueue, probe, __VA_ARGS__)
+#else
+#define LOO_TRACE(probe, ...) ((void) 0)
+#endif
+
+#endif /* LOO_QUEUE_TRACE_HPP */
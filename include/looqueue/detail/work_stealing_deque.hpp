@@ -0,0 +1,127 @@
+#ifndef LOO_QUEUE_WORK_STEALING_DEQUE_HPP
+#define LOO_QUEUE_WORK_STEALING_DEQUE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+#include "looqueue/align.hpp"
+
+namespace loo::detail {
+/**
+ * A bounded Chase-Lev work-stealing deque of `T*` pointers (see Lê et al., "Correct and Efficient
+ * Work-Stealing for Weak Memory Models", PPoPP'13).
+ *
+ * Only the owning thread may `push` and `pop` at the bottom (LIFO) and take the oldest elements in
+ * bulk through `take_oldest`, any thread may `steal` a single element from the top (FIFO).
+ * The deque does not grow, `push` fails once it holds `Capacity` elements, so the owner can move
+ * the oldest half elsewhere (e.g., to a shared queue) w/ a single CAS.
+ */
+template <typename T, std::size_t Capacity>
+class work_stealing_deque {
+  static_assert(std::has_single_bit(Capacity), "Capacity must be a power of 2");
+
+public:
+  /** pushes `elem` to the bottom (owner only), fails if the deque is full */
+  bool push(T* elem) noexcept {
+    const auto bottom = this->m_bottom.load(relaxed);
+    const auto top = this->m_top.load(acquire);
+    if (bottom - top >= std::int64_t(Capacity)) [[unlikely]] {
+      return false;
+    }
+
+    // releasing the bottom index (instead of a release fence) is equivalent, but understood by TSan
+    this->m_buffer[bottom & MASK].store(elem, relaxed);
+    this->m_bottom.store(bottom + 1, release);
+    return true;
+  }
+
+  /** pops the most recently pushed element from the bottom (owner only, `nullptr` if empty) */
+  T* pop() noexcept {
+    const auto bottom = this->m_bottom.load(relaxed) - 1;
+    this->m_bottom.store(bottom, relaxed);
+    std::atomic_thread_fence(seq_cst);
+    auto top = this->m_top.load(relaxed);
+
+    if (top > bottom) {
+      this->m_bottom.store(bottom + 1, relaxed);
+      return nullptr;
+    }
+
+    auto elem = this->m_buffer[bottom & MASK].load(relaxed);
+    if (top == bottom) {
+      // the last element may be stolen concurrently, so it is claimed like a thief would
+      if (!this->m_top.compare_exchange_strong(top, top + 1, seq_cst, relaxed)) {
+        elem = nullptr;
+      }
+
+      this->m_bottom.store(bottom + 1, relaxed);
+    }
+
+    return elem;
+  }
+
+  /** steals the oldest element from the top (any thread, `nullptr` if empty) */
+  T* steal() noexcept {
+    auto top = this->m_top.load(acquire);
+    while (true) {
+      std::atomic_thread_fence(seq_cst);
+      const auto bottom = this->m_bottom.load(acquire);
+      if (top >= bottom) {
+        return nullptr;
+      }
+
+      const auto elem = this->m_buffer[top & MASK].load(relaxed);
+      if (this->m_top.compare_exchange_strong(top, top + 1, seq_cst, relaxed)) {
+        return elem;
+      }
+    }
+  }
+
+  /**
+   * takes up to `max` of the oldest elements from the top and writes them to `out` (owner only),
+   * the owner can't pop concurrently, so all of them are claimed from thieves w/ a single CAS
+   */
+  std::size_t take_oldest(T** out, std::size_t max) noexcept {
+    auto top = this->m_top.load(acquire);
+    while (true) {
+      const auto bottom = this->m_bottom.load(relaxed);
+      const auto count = std::min<std::int64_t>(std::int64_t(max), bottom - top);
+      if (count <= 0) {
+        return 0;
+      }
+
+      for (std::int64_t idx = 0; idx < count; ++idx) {
+        out[idx] = this->m_buffer[(top + idx) & MASK].load(relaxed);
+      }
+
+      if (this->m_top.compare_exchange_strong(top, top + count, seq_cst, relaxed)) {
+        return std::size_t(count);
+      }
+    }
+  }
+
+  /** returns the (approximate) number of elements */
+  [[nodiscard]] std::size_t size() const noexcept {
+    const auto size = this->m_bottom.load(relaxed) - this->m_top.load(relaxed);
+    return size < 0 ? 0 : std::size_t(size);
+  }
+
+private:
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+  static constexpr auto seq_cst = std::memory_order_seq_cst;
+  static constexpr std::int64_t MASK = std::int64_t(Capacity) - 1;
+
+  /** the index of the oldest element, incremented by thieves (and the owner) */
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::int64_t> m_top{ 0 };
+  /** the index following the most recent element, only written by the owner */
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::int64_t> m_bottom{ 0 };
+  std::array<std::atomic<T*>, Capacity>                m_buffer{};
+};
+}
+
+#endif /* LOO_QUEUE_WORK_STEALING_DEQUE_HPP */
@@ -0,0 +1,303 @@
+#ifndef LOO_QUEUE_EXECUTOR_HPP
+#define LOO_QUEUE_EXECUTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "looqueue/align.hpp"
+#include "looqueue/queue.hpp"
+#include "looqueue/detail/backoff.hpp"
+#include "looqueue/detail/event_count.hpp"
+#include "looqueue/detail/work_stealing_deque.hpp"
+
+namespace loo {
+/**
+ * A work-stealing thread pool, whose workers each own a local Chase-Lev deque and share a
+ * `loo::queue` as global injection and overflow queue.
+ *
+ * Tasks submitted by a worker are pushed to its own deque (LIFO for the worker, other workers steal
+ * the oldest ones), so most tasks never touch the global queue's head or tail.
+ * Tasks submitted by any other thread are enqueued to the global queue, from which workers take
+ * up to `GLOBAL_BATCH` tasks at once (w/ a single `dequeue_bulk`) into their deques, a worker whose
+ * deque is full moves its oldest half to the global queue w/ a single `enqueue_bulk`.
+ * Each worker polls the global queue after every `GLOBAL_POLL_INTERVAL` tasks, so injected tasks
+ * are not starved by workers spawning further tasks.
+ *
+ * Idle workers search for tasks for a while (polling the global queue w/ read-only checks) and are
+ * then parked, submitting threads only wake a parked worker if no other worker is searching and
+ * the last searching worker to find a task wakes another one, so wake-ups propagate as needed
+ * instead of costing a system call per submitted task.
+ * Tasks must not throw, the executor must not be destroyed by one of its own workers and tasks
+ * must not be submitted by other threads once it is being destroyed.
+ */
+class executor {
+public:
+  /** the capacity of each worker's local deque */
+  static constexpr std::size_t LOCAL_CAPACITY = 256;
+  /** the max. number of tasks taken from the global queue at once */
+  static constexpr std::size_t GLOBAL_BATCH = 32;
+  /** the number of tasks each worker runs before polling the global queue */
+  static constexpr std::size_t GLOBAL_POLL_INTERVAL = 61;
+  /** the number of unsuccessful searches for tasks before a worker is parked */
+  static constexpr std::size_t IDLE_SPIN_COUNT = 16;
+
+  /** constructor (starts `workers` worker threads, at least one) */
+  explicit executor(std::size_t workers = std::thread::hardware_concurrency()) :
+    m_count{ std::max<std::size_t>(workers, 1) },
+    m_workers{ std::make_unique<worker_t[]>(this->m_count) }
+  {
+    this->m_threads.reserve(this->m_count);
+    for (std::size_t idx = 0; idx < this->m_count; ++idx) {
+      this->m_workers[idx].rng = 0x9E3779B97F4A7C15ull * (idx + 1);
+      this->m_threads.emplace_back([this, idx] { this->run_worker(idx); });
+    }
+  }
+
+  /** destructor (runs all remaining tasks, including those they submit, and joins all workers) */
+  ~executor() noexcept {
+    this->m_stop.store(true, std::memory_order_release);
+    this->m_parking.notify(std::uint32_t(this->m_count));
+    for (auto& thread : this->m_threads) {
+      thread.join();
+    }
+  }
+
+  /** returns the number of worker threads */
+  [[nodiscard]] std::size_t workers() const noexcept {
+    return this->m_count;
+  }
+
+  /** submits `fn` for execution by one of the workers */
+  template <std::invocable F>
+  void submit(F&& fn) {
+    using task_type = task_impl_t<std::decay_t<F>>;
+    this->schedule(new task_type(std::forward<F>(fn)));
+  }
+
+  /** resumes `handle` on one of the workers (e.g., for `queue::async_dequeue`) */
+  void execute(std::coroutine_handle<> handle) {
+    this->submit([handle] { handle.resume(); });
+  }
+
+  /** deleted constructors & assignment operators */
+  executor(const executor&)            = delete;
+  executor(executor&&)                 = delete;
+  executor& operator=(const executor&) = delete;
+  executor& operator=(executor&&)      = delete;
+
+private:
+  /** a type-erased task, which de-allocates itself once it has been run */
+  struct task_t {
+    void (*run)(task_t*) noexcept;
+  };
+
+  template <typename F>
+  struct task_impl_t final : task_t {
+    F fn;
+
+    explicit task_impl_t(F&& fn) : task_t{ &task_impl_t::invoke }, fn{ std::move(fn) } {}
+    explicit task_impl_t(const F& fn) : task_t{ &task_impl_t::invoke }, fn{ fn } {}
+
+    static void invoke(task_t* task) noexcept {
+      const auto self = static_cast<task_impl_t*>(task);
+      self->fn();
+      delete self;
+    }
+  };
+
+  struct alignas(CACHE_LINE_ALIGN) worker_t {
+    detail::work_stealing_deque<task_t, LOCAL_CAPACITY> deque{};
+    /** the (xorshift64*) state for choosing victims */
+    std::uint64_t rng{ 0 };
+    /** the number of tasks run since the global queue was last polled */
+    std::size_t   ticks{ 0 };
+  };
+
+  /** the worker (of any executor) running on the calling thread, if any */
+  struct context_t {
+    const executor* owner{ nullptr };
+    std::size_t     idx{ 0 };
+  };
+
+  static context_t& current() noexcept {
+    thread_local context_t context{};
+    return context;
+  }
+
+  /** pushes `task` to the calling worker's deque or enqueues it to the global queue */
+  void schedule(task_t* task) {
+    if (const auto& context = current(); context.owner == this) {
+      auto& worker = this->m_workers[context.idx];
+      if (!worker.deque.push(task)) [[unlikely]] {
+        this->spill(worker);
+        worker.deque.push(task);
+      }
+    } else {
+      this->m_global.enqueue(task);
+    }
+
+    // either a searching worker finds the task or this thread observes that none is searching
+    // (see `run_worker`)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->m_searching.load(std::memory_order_relaxed) == 0) {
+      this->m_parking.notify();
+    }
+  }
+
+  /** moves the oldest half of a full deque to the global queue */
+  void spill(worker_t& worker) {
+    std::array<task_t*, LOCAL_CAPACITY / 2> tasks;
+    const auto count = worker.deque.take_oldest(tasks.data(), tasks.size());
+    this->m_global.enqueue_bulk(tasks.begin(), tasks.begin() + count);
+  }
+
+  /**
+   * takes a batch of tasks from the global queue, returns the first and pushes all others to the
+   * worker's deque
+   */
+  task_t* take_global(worker_t& worker) {
+    // the read-only check keeps idle workers from writing to the global queue's head
+    const auto first = this->m_global.try_dequeue();
+    if (first == nullptr) {
+      return nullptr;
+    }
+
+    std::array<task_t*, GLOBAL_BATCH - 1> tasks;
+    const auto free = LOCAL_CAPACITY - std::min(worker.deque.size(), LOCAL_CAPACITY);
+    const auto count = this->m_global.dequeue_bulk(tasks.begin(), std::min(free, tasks.size()));
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      worker.deque.push(tasks[idx]);
+    }
+
+    if (count != 0) {
+      // other (parked) workers may steal some of the taken tasks
+      this->m_parking.notify();
+    }
+
+    return first;
+  }
+
+  /** attempts to steal a task from any other worker, starting at a random one */
+  task_t* steal(worker_t& worker, std::size_t idx) {
+    worker.rng ^= worker.rng >> 12;
+    worker.rng ^= worker.rng << 25;
+    worker.rng ^= worker.rng >> 27;
+    const auto start = std::size_t((worker.rng * 0x2545F4914F6CDD1Dull) >> 32) % this->m_count;
+    for (std::size_t offset = 0; offset < this->m_count; ++offset) {
+      const auto victim = (start + offset) % this->m_count;
+      if (victim == idx) {
+        continue;
+      }
+
+      if (const auto task = this->m_workers[victim].deque.steal(); task != nullptr) {
+        return task;
+      }
+    }
+
+    return nullptr;
+  }
+
+  /** returns the next task for the worker at `idx`, if there is any */
+  task_t* find_task(std::size_t idx) {
+    auto& worker = this->m_workers[idx];
+    if (++worker.ticks >= GLOBAL_POLL_INTERVAL) {
+      worker.ticks = 0;
+      if (const auto task = this->take_global(worker); task != nullptr) {
+        return task;
+      }
+    }
+
+    if (const auto task = worker.deque.pop(); task != nullptr) {
+      return task;
+    }
+
+    if (const auto task = this->take_global(worker); task != nullptr) {
+      return task;
+    }
+
+    return this->steal(worker, idx);
+  }
+
+  void run_worker(std::size_t idx) {
+    current() = { this, idx };
+    detail::exponential_backoff backoff{ 64 };
+    std::size_t idle = 0;
+    bool searching = false;
+    while (true) {
+      if (const auto task = this->find_task(idx); task != nullptr) {
+        if (searching) {
+          // further tasks may follow, which no submitting thread wakes a worker for, while this
+          // worker was still counted as searching
+          searching = false;
+          if (this->m_searching.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+            this->m_parking.notify();
+          }
+        }
+
+        task->run(task);
+        backoff.reset();
+        idle = 0;
+        continue;
+      }
+
+      if (!searching) {
+        searching = true;
+        this->m_searching.fetch_add(1, std::memory_order_seq_cst);
+      }
+
+      if (++idle < IDLE_SPIN_COUNT) {
+        backoff.spin();
+        continue;
+      }
+
+      // announce this worker as parked and search again, any task submitted after this search is
+      // guaranteed to wake up a worker (see detail::event_count)
+      searching = false;
+      this->m_searching.fetch_sub(1, std::memory_order_seq_cst);
+      const auto key = this->m_parking.prepare_wait();
+      if (const auto task = this->find_task(idx); task != nullptr) {
+        this->m_parking.cancel_wait();
+        task->run(task);
+        idle = 0;
+        continue;
+      }
+
+      // all tasks have been run, those submitted by other workers are run by these themselves
+      if (this->m_stop.load(std::memory_order_acquire)) {
+        this->m_parking.cancel_wait();
+        break;
+      }
+
+      this->m_parking.wait(key);
+      backoff.reset();
+      idle = 0;
+    }
+
+    current() = {};
+  }
+
+  /** the global injection and overflow queue */
+  queue<task_t>                m_global{};
+  /** the event count for parking idle workers */
+  alignas(CACHE_LINE_ALIGN) detail::event_count m_parking{};
+  /** the number of workers currently searching for tasks (before being parked) */
+  std::atomic<std::size_t>     m_searching{ 0 };
+  std::atomic_bool             m_stop{ false };
+  const std::size_t            m_count;
+  std::unique_ptr<worker_t[]>  m_workers;
+  std::vector<std::thread>     m_threads{};
+};
+
+static_assert(coroutine_executor<executor>, "the executor must be usable for async_dequeue");
+}
+
+#endif /* LOO_QUEUE_EXECUTOR_HPP */
@@ -0,0 +1,214 @@
+#ifndef LOO_QUEUE_HUGE_PAGE_ARENA_HPP
+#define LOO_QUEUE_HUGE_PAGE_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace loo {
+/** the kind of pages backing the chunks of a `loo::huge_page_arena` */
+enum class huge_page_backing {
+  /** no chunk has been mapped yet */
+  NONE,
+  /** explicitly reserved huge pages (MAP_HUGETLB) */
+  HUGETLB,
+  /** transparent huge pages, which were requested through madvise (but are not guaranteed) */
+  TRANSPARENT,
+  /** regular pages */
+  REGULAR,
+};
+
+/**
+ * A memory resource carving blocks (e.g., queue nodes) out of large chunks backed by huge pages,
+ * which reduces the number of TLB entries required for accessing many nodes, e.g., in queues with
+ * deep backlogs.
+ *
+ * Each chunk is first mapped with MAP_HUGETLB and, if no huge pages are reserved, mapped regularly
+ * (aligned to the huge page size) with transparent huge pages requested through madvise, if that
+ * fails as well, the chunk is backed by regular pages.
+ * De-allocated blocks are retained in per-layout free lists for re-use by subsequent allocations,
+ * the chunks themselves are only released once the arena is destroyed.
+ * All operations are serialized by a lock, so the arena should be used as upstream of a
+ * `loo::node_pool`, which serves most allocations without it.
+ */
+class huge_page_arena final : public std::pmr::memory_resource {
+public:
+  /** the (default) huge page size on x86-64 and AArch64 (w/ 4 KiB base pages) */
+  static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{ 2 } << 20;
+
+  /** constructor (the chunk size is rounded up to a multiple of the huge page size) */
+  explicit huge_page_arena(std::size_t chunk_size = HUGE_PAGE_SIZE) :
+    m_chunk_size{ round_up(std::max<std::size_t>(chunk_size, 1), HUGE_PAGE_SIZE) }
+  {}
+
+  /** destructor (releases all chunks, regardless of any outstanding blocks) */
+  ~huge_page_arena() noexcept override {
+    for (const auto& chunk : this->m_chunks) {
+      unmap_chunk(chunk);
+    }
+  }
+
+  /** returns the backing of the most recently mapped chunk */
+  [[nodiscard]] huge_page_backing backing() const {
+    std::lock_guard guard{ this->m_lock };
+    return this->m_chunks.empty() ? huge_page_backing::NONE : this->m_chunks.back().backing;
+  }
+
+  /** returns the number of mapped chunks */
+  [[nodiscard]] std::size_t chunks() const {
+    std::lock_guard guard{ this->m_lock };
+    return this->m_chunks.size();
+  }
+
+  /** deleted constructors & assignment operators */
+  huge_page_arena(const huge_page_arena&)            = delete;
+  huge_page_arena(huge_page_arena&&)                 = delete;
+  huge_page_arena& operator=(const huge_page_arena&) = delete;
+  huge_page_arena& operator=(huge_page_arena&&)      = delete;
+
+private:
+  struct chunk_t {
+    void*             addr;
+    std::size_t       size;
+    huge_page_backing backing;
+  };
+
+  /** an intrusive list of de-allocated blocks of the same layout */
+  struct free_list_t {
+    std::size_t bytes, alignment;
+    void*       head;
+  };
+
+  static std::size_t round_up(std::size_t value, std::size_t align) noexcept {
+    return (value + align - 1) / align * align;
+  }
+
+  /** maps a new chunk of `size` bytes aligned to the huge page size */
+  static chunk_t map_chunk(std::size_t size) {
+#if defined(__linux__)
+  #if defined(MAP_HUGETLB)
+    const auto flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (const auto addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+        addr != MAP_FAILED
+    ) {
+      return { addr, size, huge_page_backing::HUGETLB };
+    }
+  #endif
+
+    // no (sufficient) huge pages are reserved, so the chunk is mapped regularly, over-allocating
+    // for aligning it to the huge page size and trimming the excess afterwards
+    const auto map = mmap(
+        nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+    if (map == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+
+    const auto addr = reinterpret_cast<std::uintptr_t>(map);
+    const auto aligned = round_up(addr, HUGE_PAGE_SIZE);
+    if (const auto head = aligned - addr; head != 0) {
+      munmap(map, head);
+    }
+
+    if (const auto tail = HUGE_PAGE_SIZE - (aligned - addr); tail != 0) {
+      munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+
+    auto backing = huge_page_backing::REGULAR;
+  #if defined(MADV_HUGEPAGE)
+    // the pages have not been touched yet, so the kernel may back them with huge pages right away
+    if (madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE) == 0) {
+      backing = huge_page_backing::TRANSPARENT;
+    }
+  #endif
+
+    return { reinterpret_cast<void*>(aligned), size, backing };
+#else
+    const auto addr = ::operator new(size, std::align_val_t{ HUGE_PAGE_SIZE });
+    return { addr, size, huge_page_backing::REGULAR };
+#endif
+  }
+
+  static void unmap_chunk(const chunk_t& chunk) noexcept {
+#if defined(__linux__)
+    munmap(chunk.addr, chunk.size);
+#else
+    ::operator delete(chunk.addr, chunk.size, std::align_val_t{ HUGE_PAGE_SIZE });
+#endif
+  }
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    if (alignment > HUGE_PAGE_SIZE) {
+      throw std::bad_alloc();
+    }
+
+    // each free block must be able to store the link to its successor
+    bytes = std::max(bytes, sizeof(void*));
+    std::lock_guard guard{ this->m_lock };
+    auto list = this->find_free_list(bytes, alignment);
+    if (list == nullptr) {
+      // the list is created before any block of its layout is handed out, so de-allocating a block
+      // (e.g., while reclaiming a node) never has to allocate
+      list = &this->m_free_lists.emplace_back(free_list_t{ bytes, alignment, nullptr });
+    } else if (list->head != nullptr) {
+      const auto block = list->head;
+      list->head = *static_cast<void**>(block);
+      return block;
+    }
+
+    auto offset = round_up(this->m_offset, alignment);
+    if (this->m_chunks.empty() || offset + bytes > this->m_chunks.back().size) {
+      // the remainder of the current chunk (less than one block) is wasted, reserving first
+      // ensures a mapped chunk is never leaked
+      this->m_chunks.reserve(this->m_chunks.size() + 1);
+      const auto size = std::max(this->m_chunk_size, round_up(bytes, HUGE_PAGE_SIZE));
+      this->m_chunks.push_back(map_chunk(size));
+      offset = 0;
+    }
+
+    this->m_offset = offset + bytes;
+    return static_cast<char*>(this->m_chunks.back().addr) + offset;
+  }
+
+  void do_deallocate(void* block, std::size_t bytes, std::size_t alignment) override {
+    bytes = std::max(bytes, sizeof(void*));
+    std::lock_guard guard{ this->m_lock };
+    // the block's layout has been allocated before, so its free list must exist
+    const auto list = this->find_free_list(bytes, alignment);
+    *static_cast<void**>(block) = list->head;
+    list->head = block;
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  /** returns the free list for the given layout, if there is one (the lock must be held) */
+  free_list_t* find_free_list(std::size_t bytes, std::size_t alignment) {
+    for (auto& list : this->m_free_lists) {
+      if (list.bytes == bytes && list.alignment == alignment) {
+        return &list;
+      }
+    }
+
+    return nullptr;
+  }
+
+  const std::size_t        m_chunk_size;
+  mutable std::mutex       m_lock;
+  std::vector<chunk_t>     m_chunks{};
+  /** the offset of the first unused byte in the most recently mapped chunk */
+  std::size_t              m_offset{ 0 };
+  std::vector<free_list_t> m_free_lists{};
+};
+}
+
+#endif /* LOO_QUEUE_HUGE_PAGE_ARENA_HPP */
@@ -0,0 +1,252 @@
+#ifndef LOO_QUEUE_MULTI_QUEUE_HPP
+#define LOO_QUEUE_MULTI_QUEUE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "looqueue/align.hpp"
+#include "looqueue/queue.hpp"
+#include "looqueue/stats.hpp"
+
+namespace loo {
+/** the strategies for choosing a shard of a `loo::multi_queue` */
+enum class multi_queue_choice {
+  /** a random shard is chosen */
+  RANDOM,
+  /**
+   * the less (enqueue) or more (dequeue) populated of two random shards is chosen, which requires
+   * counting all operations per shard, but reduces the rank error
+   */
+  TWO_CHOICE,
+};
+
+/** construction options for `loo::multi_queue` */
+struct multi_queue_options {
+  /** the number of internal queues (shards), 0 means twice the number of hardware threads */
+  std::size_t        shards = 0;
+  /** the number of consecutive operations of each thread on the same shard (at least 1) */
+  std::size_t        stickiness = 8;
+  /** the strategy for choosing shards */
+  multi_queue_choice choice = multi_queue_choice::RANDOM;
+  /** the options for each individual shard */
+  queue_options      queue{};
+};
+
+namespace detail {
+/** the sticky shard choices of a thread for a single multi queue */
+struct multi_queue_sticky_t {
+  /** the id of the multi queue (0 if unused) */
+  std::uint64_t queue_id = 0;
+  std::size_t   enq_idx  = 0, deq_idx  = 0;
+  std::size_t   enq_left = 0, deq_left = 0;
+};
+
+/**
+ * the per-thread state for choosing shards, the random number generator is shared by all multi
+ * queues, the sticky choices are kept separately for the most recently used queues
+ */
+struct multi_queue_state_t {
+  /** the number of multi queues for which each thread retains its sticky choices */
+  static constexpr std::size_t CACHED_QUEUES = 4;
+
+  std::uint64_t rng;
+  std::array<multi_queue_sticky_t, CACHED_QUEUES> sticky{};
+  /** the next entry to be replaced (round-robin) */
+  std::size_t replace = 0;
+
+  /** returns a (xorshift64*) random number in [0, bound) */
+  std::size_t next(std::size_t bound) noexcept {
+    this->rng ^= this->rng >> 12;
+    this->rng ^= this->rng << 25;
+    this->rng ^= this->rng >> 27;
+    const auto rand = (this->rng * 0x2545F4914F6CDD1Dull) >> 32;
+    return std::size_t((rand * bound) >> 32);
+  }
+
+  /**
+   * returns the sticky choices for the multi queue `queue_id`, replacing those of another queue
+   * (which has to choose new shards once it is used again) if there are none
+   */
+  multi_queue_sticky_t& sticky_for(std::uint64_t queue_id) noexcept {
+    for (auto& entry : this->sticky) {
+      if (entry.queue_id == queue_id) {
+        return entry;
+      }
+    }
+
+    auto& entry = this->sticky[this->replace++ % CACHED_QUEUES];
+    entry = multi_queue_sticky_t{ .queue_id = queue_id };
+    return entry;
+  }
+};
+
+inline multi_queue_state_t& multi_queue_state() noexcept {
+  thread_local multi_queue_state_t state{ 0x9E3779B97F4A7C15ull * (thread_index() + 1) };
+  return state;
+}
+
+/** returns a unique id for a new multi queue, which (unlike its address) is never re-used */
+inline std::uint64_t next_multi_queue_id() noexcept {
+  static std::atomic<std::uint64_t> next{ 1 };
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+}
+
+/**
+ * A relaxed FIFO queue, which spreads all operations across multiple `loo::queue` instances
+ * (shards) in order to scale beyond the contention on a single queue's head and tail.
+ *
+ * Each thread performs `stickiness` consecutive enqueue (or dequeue) operations on the same shard
+ * before choosing another one, a dequeue operation falls back to all other shards (in order) if
+ * the chosen one is empty and only fails if all shards were found empty.
+ *
+ * Ordering guarantees: Each shard is a linearizable FIFO queue, but elements in different shards
+ * are unordered, so an element may be dequeued before older elements in other shards.
+ * The expected number of such older elements (rank error) grows with the number of shards and the
+ * stickiness (see `bench_loo --rank-error`).
+ */
+template <typename T, std::size_t NodeSize = DEFAULT_NODE_SIZE, typename... Policies>
+class multi_queue {
+public:
+  using queue_type  = queue<T, NodeSize, Policies...>;
+  using value_type  = typename queue_type::value_type;
+  using result_type = typename queue_type::result_type;
+
+  /** any thread may access any shard, so the same limits as for each individual shard apply */
+  static constexpr std::size_t MAX_PRODUCER_THREADS = queue_type::MAX_PRODUCER_THREADS;
+  static constexpr std::size_t MAX_CONSUMER_THREADS = queue_type::MAX_CONSUMER_THREADS;
+
+  /** constructor (default) */
+  multi_queue() : multi_queue(multi_queue_options{}) {}
+  /** constructor w/ the number of shards */
+  explicit multi_queue(std::size_t shards) : multi_queue(multi_queue_options{ .shards = shards }) {}
+  /** constructor w/ options */
+  explicit multi_queue(const multi_queue_options& options) :
+    m_stickiness{ std::max<std::size_t>(options.stickiness, 1) },
+    m_choice{ options.choice }
+  {
+    auto shards = options.shards;
+    if (shards == 0) {
+      shards = 2 * std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    this->m_shards.reserve(shards);
+    for (std::size_t idx = 0; idx < shards; ++idx) {
+      this->m_shards.push_back(std::make_unique<shard_t>(options.queue));
+    }
+  }
+
+  /** enqueue an element to the back of the calling thread's current shard */
+  void enqueue(value_type elem) {
+    auto& state = detail::multi_queue_state();
+    auto& sticky = state.sticky_for(this->m_id);
+    if (sticky.enq_left == 0) {
+      sticky.enq_idx = this->choose(state, true);
+      sticky.enq_left = this->m_stickiness;
+    }
+
+    --sticky.enq_left;
+    auto& shard = *this->m_shards[sticky.enq_idx];
+    shard.queue.enqueue(elem);
+    if (this->m_choice == multi_queue_choice::TWO_CHOICE) {
+      shard.enqueued.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * dequeue an element from the front of the calling thread's current shard or, if it is empty,
+   * from the first non-empty other shard (`nullptr` or empty if all shards are empty)
+   */
+  result_type dequeue() {
+    auto& state = detail::multi_queue_state();
+    auto& sticky = state.sticky_for(this->m_id);
+    if (sticky.deq_left == 0) {
+      sticky.deq_idx = this->choose(state, false);
+      sticky.deq_left = this->m_stickiness;
+    }
+
+    --sticky.deq_left;
+    const auto count = this->m_shards.size();
+    const auto first = sticky.deq_idx;
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto idx = (first + i) % count;
+      auto& shard = *this->m_shards[idx];
+      if (auto res = shard.queue.dequeue(); res) {
+        if (this->m_choice == multi_queue_choice::TWO_CHOICE) {
+          shard.dequeued.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (i != 0) {
+          // the chosen shard was empty, so the following operations continue on this one instead
+          sticky.deq_idx = idx;
+          sticky.deq_left = this->m_stickiness - 1;
+        }
+
+        return res;
+      }
+    }
+
+    // all shards are empty, so a new shard is chosen for the next operation
+    sticky.deq_left = 0;
+    return result_type{};
+  }
+
+  /** returns the number of shards */
+  [[nodiscard]] std::size_t shards() const noexcept {
+    return this->m_shards.size();
+  }
+
+  /** returns the shard with the given index */
+  queue_type& shard(std::size_t idx) noexcept {
+    return this->m_shards[idx]->queue;
+  }
+
+private:
+  struct shard_t {
+    queue_type queue;
+    /** the counts of all operations (TWO_CHOICE only), which estimate the shard's size */
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint64_t> enqueued{ 0 };
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint64_t> dequeued{ 0 };
+
+    explicit shard_t(const queue_options& options) : queue{ options } {}
+
+    [[nodiscard]] std::int64_t size() const noexcept {
+      // both loads are not atomic, so the estimate may be (slightly) negative
+      const auto dequeued = this->dequeued.load(std::memory_order_relaxed);
+      return std::int64_t(this->enqueued.load(std::memory_order_relaxed) - dequeued);
+    }
+  };
+
+  /** chooses a shard for the next operations (enqueue or dequeue) of the calling thread */
+  std::size_t choose(detail::multi_queue_state_t& state, bool enqueue) const noexcept {
+    const auto count = this->m_shards.size();
+    const auto first = state.next(count);
+    if (this->m_choice == multi_queue_choice::RANDOM || count == 1) {
+      return first;
+    }
+
+    const auto second = state.next(count);
+    const auto first_size = this->m_shards[first]->size();
+    const auto second_size = this->m_shards[second]->size();
+    // enqueue to the shorter and dequeue from the longer shard, which keeps all shards balanced
+    if (enqueue) {
+      return second_size < first_size ? second : first;
+    } else {
+      return second_size > first_size ? second : first;
+    }
+  }
+
+  /** the id identifying the sticky choices of each thread for this queue */
+  const std::uint64_t                   m_id{ detail::next_multi_queue_id() };
+  const std::size_t                     m_stickiness;
+  const multi_queue_choice              m_choice;
+  std::vector<std::unique_ptr<shard_t>> m_shards;
+};
+}
+
+#endif /* LOO_QUEUE_MULTI_QUEUE_HPP */
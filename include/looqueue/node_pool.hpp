@@ -0,0 +1,200 @@
+#ifndef LOO_QUEUE_NODE_POOL_HPP
+#define LOO_QUEUE_NODE_POOL_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+#include "looqueue/align.hpp"
+
+namespace loo {
+/**
+ * A lock-free memory resource retaining up to `capacity` de-allocated blocks of a single fixed
+ * layout (size & alignment) for re-use by subsequent allocations.
+ *
+ * The layout is determined by the first allocation request (unless set through `set_layout`),
+ * requests for any other layout are always forwarded to the upstream resource.
+ * A pool may hence be shared by any number of queues, as long as they all use the same node type.
+ * Retained blocks are kept in a bounded array (see D. Vyukov's bounded MPMC queue), which never
+ * blocks: If the array is either (momentarily) full or empty, blocks are simply released to or
+ * requested from the upstream resource instead.
+ */
+class node_pool final : public std::pmr::memory_resource {
+public:
+  /** constructor */
+  explicit node_pool(
+      std::size_t capacity,
+      std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()
+  ) :
+    m_upstream{ upstream },
+    m_capacity{ capacity },
+    m_cells{ capacity == 0 ? nullptr : std::make_unique<cell_t[]>(capacity) }
+  {
+    for (std::size_t pos = 0; pos < capacity; ++pos) {
+      this->m_cells[pos].seq.store(pos, relaxed);
+    }
+  }
+
+  /** destructor (releases all retained blocks to the upstream resource) */
+  ~node_pool() noexcept override {
+    const auto [bytes, alignment] = decompose_layout(this->m_layout.load(relaxed));
+    while (auto block = this->try_pop()) {
+      this->m_upstream->deallocate(block, bytes, alignment);
+    }
+  }
+
+  /** returns the maximum number of retained blocks */
+  [[nodiscard]] std::size_t capacity() const noexcept {
+    return this->m_capacity;
+  }
+
+  /**
+   * determines the pooled layout ahead of the first allocation (e.g., if blocks of other layouts
+   * are requested first), returns false if another layout has already been determined
+   */
+  bool set_layout(std::size_t bytes, std::size_t alignment) noexcept {
+    auto expected = std::uint64_t{ 0 };
+    const auto layout = compose_layout(bytes, alignment);
+    return this->m_layout.compare_exchange_strong(expected, layout, relaxed, relaxed)
+        || expected == layout;
+  }
+
+  /** returns the upstream resource */
+  [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept {
+    return this->m_upstream;
+  }
+
+  /** deleted constructors & assignment operators */
+  node_pool(const node_pool&)            = delete;
+  node_pool(node_pool&&)                 = delete;
+  node_pool& operator=(const node_pool&) = delete;
+  node_pool& operator=(node_pool&&)      = delete;
+
+private:
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+
+  struct cell_t {
+    std::atomic<std::size_t> seq{ 0 };
+    void*                    block{ nullptr };
+  };
+
+  struct layout_t {
+    std::size_t bytes, alignment;
+  };
+
+  /** packs the (size, log2(alignment)) pair of a block layout into a single word */
+  static std::uint64_t compose_layout(std::size_t bytes, std::size_t alignment) {
+    return (std::uint64_t{ bytes } << 8) | std::uint64_t(std::countr_zero(alignment));
+  }
+
+  static layout_t decompose_layout(std::uint64_t layout) {
+    return { std::size_t(layout >> 8), std::size_t{ 1 } << (layout & 0xFF) };
+  }
+
+  /** returns true if blocks of the given layout can be retained by the pool */
+  bool is_pooled_layout(std::size_t bytes, std::size_t alignment) {
+    if (this->m_capacity == 0) {
+      return false;
+    }
+
+    const auto layout = compose_layout(bytes, alignment);
+    auto expected = this->m_layout.load(relaxed);
+    if (expected == 0) {
+      // the first request determines the pooled layout
+      if (this->m_layout.compare_exchange_strong(expected, layout, relaxed, relaxed)) {
+        return true;
+      }
+    }
+
+    return expected == layout;
+  }
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    if (this->is_pooled_layout(bytes, alignment)) {
+      if (auto block = this->try_pop(); block != nullptr) {
+        return block;
+      }
+    }
+
+    return this->m_upstream->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* block, std::size_t bytes, std::size_t alignment) override {
+    if (!this->is_pooled_layout(bytes, alignment) || !this->try_push(block)) {
+      this->m_upstream->deallocate(block, bytes, alignment);
+    }
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  /** attempts to store `block` in a free cell, fails if all cells are (momentarily) occupied */
+  bool try_push(void* block) {
+    auto pos = this->m_push_pos.load(relaxed);
+    while (true) {
+      auto& cell = this->m_cells[pos % this->m_capacity];
+      const auto seq = cell.seq.load(acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+      if (diff == 0) {
+        // the cell is free, attempt to reserve it for this thread
+        if (this->m_push_pos.compare_exchange_weak(pos, pos + 1, relaxed, relaxed)) {
+          cell.block = block;
+          cell.seq.store(pos + 1, release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // the cell still contains a block from the previous round, so the pool is full
+        return false;
+      } else {
+        pos = this->m_push_pos.load(relaxed);
+      }
+    }
+  }
+
+  /** attempts to retrieve a block from an occupied cell, fails if the pool is (momentarily) empty */
+  void* try_pop() {
+    if (this->m_capacity == 0) {
+      return nullptr;
+    }
+
+    auto pos = this->m_pop_pos.load(relaxed);
+    while (true) {
+      auto& cell = this->m_cells[pos % this->m_capacity];
+      const auto seq = cell.seq.load(acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+
+      if (diff == 0) {
+        // the cell is occupied, attempt to reserve it for this thread
+        if (this->m_pop_pos.compare_exchange_weak(pos, pos + 1, relaxed, relaxed)) {
+          const auto block = cell.block;
+          cell.seq.store(pos + this->m_capacity, release);
+          return block;
+        }
+      } else if (diff < 0) {
+        // the cell has not been filled yet, so the pool is empty
+        return nullptr;
+      } else {
+        pos = this->m_pop_pos.load(relaxed);
+      }
+    }
+  }
+
+  std::pmr::memory_resource* const m_upstream;
+  const std::size_t                m_capacity;
+  std::unique_ptr<cell_t[]>        m_cells;
+  /** the pooled block layout, 0 until the first allocation */
+  std::atomic<std::uint64_t>       m_layout{ 0 };
+
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> m_push_pos{ 0 };
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> m_pop_pos{ 0 };
+};
+}
+
+#endif /* LOO_QUEUE_NODE_POOL_HPP */
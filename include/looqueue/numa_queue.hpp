@@ -0,0 +1,180 @@
+#ifndef LOO_QUEUE_NUMA_QUEUE_HPP
+#define LOO_QUEUE_NUMA_QUEUE_HPP
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "looqueue/node_pool.hpp"
+#include "looqueue/numa_resource.hpp"
+#include "looqueue/queue.hpp"
+#include "looqueue/detail/numa.hpp"
+
+namespace loo {
+/** the mapping of CPUs to NUMA nodes */
+struct numa_topology {
+  /** the NUMA node ids (negative for emulated nodes, to which no memory policy is applied) */
+  std::vector<int>         nodes{ -1 };
+  /** the index (into `nodes`) of each CPU's node, CPUs not contained belong to the first node */
+  std::vector<std::size_t> cpu_nodes{};
+
+  /** returns the index (into `nodes`) of the node of the given CPU */
+  [[nodiscard]] std::size_t node_of(std::size_t cpu) const noexcept {
+    return cpu < this->cpu_nodes.size() ? this->cpu_nodes[cpu] : 0;
+  }
+
+  /** detects the system's topology (Linux only, otherwise a single emulated node is returned) */
+  static numa_topology detect() {
+    const std::string root = "/sys/devices/system/node/";
+    const auto online = detail::parse_sysfs_list(detail::read_sysfs_file(root + "online"));
+    if (online.empty()) {
+      return {};
+    }
+
+    numa_topology res{ {}, {} };
+    for (const auto node : online) {
+      const auto idx = res.nodes.size();
+      res.nodes.push_back(int(node));
+
+      const auto path = root + "node" + std::to_string(node) + "/cpulist";
+      for (const auto cpu : detail::parse_sysfs_list(detail::read_sysfs_file(path))) {
+        res.cpu_nodes.resize(std::max(res.cpu_nodes.size(), cpu + 1), 0);
+        res.cpu_nodes[cpu] = idx;
+      }
+    }
+
+    return res;
+  }
+
+  /**
+   * emulates `count` nodes by dividing all CPUs into (contiguous) groups of equal size, which is
+   * useful for testing on single-node systems
+   */
+  static numa_topology emulate(std::size_t count) {
+    count = std::max<std::size_t>(count, 1);
+    const auto cpus = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+    numa_topology res{ std::vector<int>(count, -1), std::vector<std::size_t>(cpus, 0) };
+    for (std::size_t cpu = 0; cpu < cpus; ++cpu) {
+      res.cpu_nodes[cpu] = cpu * count / cpus;
+    }
+
+    return res;
+  }
+};
+
+/**
+ * A NUMA-aware front-end for `loo::queue`, which maintains one queue (shard) per NUMA node with all
+ * nodes allocated node-locally (see `loo::numa_resource`).
+ *
+ * Producers always enqueue to the shard of the NUMA node they are currently running on and
+ * consumers dequeue from their local shard first and only steal from the other shards (in order)
+ * when it is empty.
+ *
+ * Ordering guarantees: Each shard is a linearizable FIFO queue, so elements enqueued by the same
+ * thread to the same shard (i.e., while it is running on the same NUMA node) are dequeued in FIFO
+ * order.
+ * There is no order between elements in different shards, e.g., a thread migrating to another
+ * node may have its later elements dequeued before its earlier ones, and `dequeue` may return
+ * nothing while another shard becomes non-empty concurrently (there is no atomic snapshot across
+ * all shards).
+ */
+template <typename T, std::size_t NodeSize = DEFAULT_NODE_SIZE, typename... Policies>
+class numa_queue {
+public:
+  using queue_type  = queue<T, NodeSize, Policies...>;
+  using value_type  = typename queue_type::value_type;
+  using result_type = typename queue_type::result_type;
+
+  /** any thread may access any shard, so the same limits as for each individual shard apply */
+  static constexpr std::size_t MAX_PRODUCER_THREADS = queue_type::MAX_PRODUCER_THREADS;
+  static constexpr std::size_t MAX_CONSUMER_THREADS = queue_type::MAX_CONSUMER_THREADS;
+  /** the default number of reclaimed nodes retained by each shard's pool for re-use */
+  static constexpr std::size_t DEFAULT_POOL_CAPACITY = 16;
+
+  /** constructor (default) using the detected system topology */
+  numa_queue() : numa_queue(numa_topology::detect()) {}
+  /** constructor w/ explicit topology and pool capacity per shard */
+  explicit numa_queue(numa_topology topology, std::size_t pool_capacity = DEFAULT_POOL_CAPACITY) :
+    m_topology{ std::move(topology) }
+  {
+    this->m_shards.reserve(this->m_topology.nodes.size());
+    for (const auto node : this->m_topology.nodes) {
+      this->m_shards.push_back(std::make_unique<shard_t>(node, pool_capacity));
+    }
+  }
+
+  /** enqueue an element to the back of the local shard */
+  void enqueue(value_type elem) {
+    this->local_shard().queue.enqueue(elem);
+  }
+
+  /** enqueue all elements in [first, last) to the back of the local shard in order */
+  template <std::forward_iterator It>
+  void enqueue_bulk(It first, It last) {
+    this->local_shard().queue.enqueue_bulk(first, last);
+  }
+
+  /**
+   * dequeue an element from the front of the local shard or, if it is empty, from the first
+   * non-empty remote shard (`nullptr` or empty if all shards are empty)
+   */
+  result_type dequeue() {
+    const auto local = this->local_shard_idx();
+    const auto count = this->m_shards.size();
+    // the local shard is visited first, then all remote shards in order
+    for (std::size_t i = 0; i < count; ++i) {
+      if (auto res = this->m_shards[(local + i) % count]->queue.dequeue(); res) {
+        return res;
+      }
+    }
+
+    return result_type{};
+  }
+
+  /** returns the number of shards (NUMA nodes) */
+  [[nodiscard]] std::size_t shards() const noexcept {
+    return this->m_shards.size();
+  }
+
+  /** returns the shard with the given index */
+  queue_type& shard(std::size_t idx) noexcept {
+    return this->m_shards[idx]->queue;
+  }
+
+  /** returns the index of the calling thread's local shard */
+  [[nodiscard]] std::size_t local_shard_idx() const noexcept {
+    return this->m_topology.node_of(detail::current_cpu());
+  }
+
+  /** returns the queue's topology */
+  [[nodiscard]] const numa_topology& topology() const noexcept {
+    return this->m_topology;
+  }
+
+private:
+  /** a queue and the node-local resources from which its nodes are allocated */
+  struct shard_t {
+    numa_resource resource;
+    node_pool     pool;
+    queue_type    queue;
+
+    shard_t(int node, std::size_t pool_capacity) :
+      resource{ node },
+      pool{ pool_capacity, &this->resource },
+      queue{ this->pool }
+    {}
+  };
+
+  shard_t& local_shard() noexcept {
+    return *this->m_shards[this->local_shard_idx()];
+  }
+
+  numa_topology                         m_topology;
+  std::vector<std::unique_ptr<shard_t>> m_shards;
+};
+}
+
+#endif /* LOO_QUEUE_NUMA_QUEUE_HPP */
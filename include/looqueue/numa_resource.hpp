@@ -0,0 +1,95 @@
+#ifndef LOO_QUEUE_NUMA_RESOURCE_HPP
+#define LOO_QUEUE_NUMA_RESOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "looqueue/detail/numa.hpp"
+
+namespace loo {
+/**
+ * A memory resource allocating all blocks (e.g., queue nodes) from pages preferably placed on a
+ * single NUMA node.
+ *
+ * Each block is mapped separately, since memory policies apply to entire pages, so this resource
+ * should be used as upstream of a `loo::node_pool`, which amortizes the cost of mapping.
+ * If `node` is negative, or on platforms without NUMA support, no memory policy is applied.
+ */
+class numa_resource final : public std::pmr::memory_resource {
+public:
+  /** constructor */
+  explicit numa_resource(int node) noexcept : m_node{ node } {}
+
+  /** returns the NUMA node on which all memory is preferably placed (negative if none) */
+  [[nodiscard]] int node() const noexcept {
+    return this->m_node;
+  }
+
+private:
+#if defined(__linux__)
+  static std::size_t page_size() noexcept {
+    static const auto size = std::size_t(sysconf(_SC_PAGESIZE));
+    return size;
+  }
+
+  static std::size_t round_up(std::size_t value, std::size_t align) noexcept {
+    return (value + align - 1) / align * align;
+  }
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    const auto page = page_size();
+    const auto size = round_up(bytes, page);
+    // over-allocate if pages do not satisfy the requested alignment and trim the excess afterwards
+    const auto excess = alignment > page ? alignment - page : 0;
+    const auto map = mmap(
+        nullptr, size + excess, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+    if (map == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+
+    const auto addr = reinterpret_cast<std::uintptr_t>(map);
+    const auto aligned = round_up(addr, alignment);
+    if (const auto head = aligned - addr; head != 0) {
+      munmap(map, head);
+    }
+
+    if (const auto tail = excess - (aligned - addr); tail != 0) {
+      munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+
+    const auto block = reinterpret_cast<void*>(aligned);
+    // the pages have not been touched yet, so they will be placed according to the policy
+    detail::mbind_preferred(block, size, this->m_node);
+    return block;
+  }
+
+  void do_deallocate(void* block, std::size_t bytes, std::size_t) override {
+    munmap(block, round_up(bytes, page_size()));
+  }
+#else
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    return ::operator new(bytes, std::align_val_t{ alignment });
+  }
+
+  void do_deallocate(void* block, std::size_t bytes, std::size_t alignment) override {
+    ::operator delete(block, bytes, std::align_val_t{ alignment });
+  }
+#endif
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  const int m_node;
+};
+}
+
+#endif /* LOO_QUEUE_NUMA_RESOURCE_HPP */
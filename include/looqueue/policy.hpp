@@ -0,0 +1,375 @@
+#ifndef LOO_QUEUE_POLICY_HPP
+#define LOO_QUEUE_POLICY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#include "align.hpp"
+#include "detail/backoff.hpp"
+#include "detail/marked_ptr.hpp"
+#include "detail/native_marked_ptr.hpp"
+#include "detail/relative_ptr.hpp"
+
+/**
+ * Policies customize a `loo::queue` through its trailing template parameters, e.g.,
+ * `loo::queue<T, 1024, loo::high_bit_tagging<>>`, each policy belongs to exactly one category
+ * (`policy_category`) and at most one policy per category may be given.
+ */
+namespace loo {
+namespace detail {
+/** policy categories */
+struct tagging_policy_tag {};
+struct stats_policy_tag {};
+struct producer_policy_tag {};
+struct consumer_policy_tag {};
+struct spare_policy_tag {};
+struct wait_policy_tag {};
+struct deleter_policy_tag {};
+struct padding_policy_tag {};
+struct growth_policy_tag {};
+struct blocking_policy_tag {};
+struct addressing_policy_tag {};
+
+/** selects the policy of `Category` from `Policies` or `Default` if there is none */
+template <typename Category, typename Default, typename... Policies>
+struct select_policy {
+  using type = Default;
+};
+
+template <typename Category, typename Default, typename Policy, typename... Policies>
+struct select_policy<Category, Default, Policy, Policies...> {
+  using type = std::conditional_t<
+      std::is_same_v<typename Policy::policy_category, Category>,
+      Policy,
+      typename select_policy<Category, Default, Policies...>::type
+  >;
+};
+
+template <typename Category, typename Default, typename... Policies>
+using select_policy_t = typename select_policy<Category, Default, Policies...>::type;
+
+/** the number of policies of `Category` in `Policies` */
+template <typename Category, typename... Policies>
+constexpr std::size_t count_policies =
+    (std::size_t{ 0 } + ... + std::is_same_v<typename Policies::policy_category, Category>);
+}
+
+/**
+ * Stores the index in the low bits of each (head/tail) node pointer, so nodes must be aligned to
+ * twice their number of slots.
+ *
+ * This is the default tagging policy, it is portable, but limits the number of threads to the node
+ * size (see PROOF.md) and wastes some memory for aligning each node.
+ */
+struct low_bit_tagging {
+  using policy_category = detail::tagging_policy_tag;
+
+  template <std::size_t NodeSize>
+  static constexpr std::size_t tag_bits = std::bit_width(NodeSize);
+  template <std::size_t NodeSize>
+  static constexpr std::size_t node_align = std::size_t{ 1 } << tag_bits<NodeSize>;
+
+  template <typename Node, std::size_t TagBits>
+  using marked_ptr_t = detail::marked_ptr_t<Node, TagBits>;
+};
+
+/**
+ * Stores the index in the (unused) high bits of each (head/tail) node pointer, which requires all
+ * node addresses to fit into `AddressBits` bits, i.e., 48 bits for x86-64 and AArch64 user space
+ * (or 57 bits on x86-64 with 5-level paging, if the allocator hands out such addresses).
+ *
+ * Nodes only have to be cache-line aligned and up to 16 tag bits (the limit for the reclamation
+ * counters) are available regardless of the node size, raising the max. number of threads to
+ * `2^16 - NodeSize + 1` producers (and half as many consumers).
+ * Nodes with addresses exceeding `AddressBits` are rejected with `std::bad_alloc`.
+ */
+template <std::size_t AddressBits = 48>
+struct high_bit_tagging {
+  static_assert(AddressBits >= 48 && AddressBits < 64, "AddressBits must be in [48, 64)");
+  using policy_category = detail::tagging_policy_tag;
+
+  template <std::size_t NodeSize>
+  static constexpr std::size_t tag_bits = 64 - AddressBits;
+  template <std::size_t NodeSize>
+  static constexpr std::size_t node_align = CACHE_LINE_ALIGN;
+
+  template <typename Node, std::size_t TagBits>
+  using marked_ptr_t = detail::native_marked_ptr_t<Node, TagBits>;
+};
+
+/** Any number of threads may enqueue elements concurrently (default). */
+struct multi_producer {
+  using policy_category = detail::producer_policy_tag;
+  static constexpr bool single = false;
+};
+
+/**
+ * Only a single thread at a time may enqueue elements, which is not checked.
+ *
+ * The producer advances the tail index with plain loads and stores instead of FAA and publishes
+ * each element only after it has been written, appending nodes requires no CAS and the slow-path
+ * enqueue count is not required for reclamation.
+ */
+struct single_producer {
+  using policy_category = detail::producer_policy_tag;
+  static constexpr bool single = true;
+};
+
+/** Any number of threads may dequeue elements concurrently (default). */
+struct multi_consumer {
+  using policy_category = detail::consumer_policy_tag;
+  static constexpr bool single = false;
+};
+
+/**
+ * Only a single thread at a time may dequeue elements, which is not checked.
+ *
+ * The consumer advances the head index with plain loads and stores instead of FAA and checks
+ * for elements before reserving a slot, advancing the head requires no CAS and the slow-path
+ * dequeue count is not required for reclamation.
+ * Combined with `single_producer`, slots are accessed with plain loads and stores as well and the
+ * consumer reclaims each node directly once it has advanced past it.
+ */
+struct single_consumer {
+  using policy_category = detail::consumer_policy_tag;
+  static constexpr bool single = true;
+};
+
+/** Nodes are allocated and initialized on demand in the enqueue slow path (default). */
+struct no_spare_node {
+  using policy_category = detail::spare_policy_tag;
+  static constexpr bool enabled = false;
+
+  template <std::size_t NodeSize>
+  static constexpr std::size_t watermark = NodeSize;
+};
+
+/**
+ * A spare node is prepared (allocated and initialized) ahead of time by the producer, which
+ * reserves the slot at `Percent`% of each tail node, so the enqueue slow path only has to append
+ * the prepared node instead of initializing all of its slots while other producers are waiting.
+ *
+ * A node prepared by a producer losing the race for appending its node is retained as spare node
+ * as well, at most one spare node exists at any time.
+ */
+template <std::size_t Percent = 50>
+struct spare_node {
+  static_assert(Percent < 100, "the watermark must be within the node");
+  using policy_category = detail::spare_policy_tag;
+  static constexpr bool enabled = true;
+
+  template <std::size_t NodeSize>
+  static constexpr std::size_t watermark = NodeSize * Percent / 100;
+};
+
+/**
+ * A consumer finding its reserved slot still empty sets the READER bit right away, so both the
+ * consumer and the producer abandon the slot and retry with another one (default).
+ */
+struct no_wait {
+  using policy_category = detail::wait_policy_tag;
+  static constexpr bool enabled = false;
+
+  template <typename Ready>
+  static bool wait(Ready&&) noexcept {
+    return false;
+  }
+};
+
+/**
+ * A consumer finding its reserved slot still empty, although the slot's producer has already
+ * reserved it (i.e., is about to write it), spins for up to `Spins` attempts before abandoning it.
+ */
+template <std::size_t Spins = 64>
+struct spin_wait {
+  using policy_category = detail::wait_policy_tag;
+  static constexpr bool enabled = true;
+
+  template <typename Ready>
+  static bool wait(Ready&& ready) {
+    for (std::size_t spin = 0; spin < Spins; ++spin) {
+      detail::cpu_relax();
+      if (ready()) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+};
+
+/**
+ * Like `spin_wait`, but each thread spins for up to twice the number of spins recently required
+ * for slots to be written (at least `MIN_SPINS`, at most `MaxSpins`), so it spins only briefly
+ * after repeatedly abandoning slots anyways, e.g., due to preempted producers.
+ */
+template <std::size_t MaxSpins = 1024>
+struct adaptive_wait {
+  static_assert(MaxSpins > 0, "at least one spin is required");
+  using policy_category = detail::wait_policy_tag;
+  static constexpr bool enabled = true;
+  static constexpr std::size_t MIN_SPINS = std::min<std::size_t>(16, MaxSpins);
+
+  template <typename Ready>
+  static bool wait(Ready&& ready) {
+    auto& estimate = estimated_spins();
+    const auto limit = std::clamp(2 * estimate, MIN_SPINS, MaxSpins);
+    for (std::size_t spin = 1; spin <= limit; ++spin) {
+      detail::cpu_relax();
+      if (ready()) {
+        // move the estimate by 1/8 of its distance towards the spins required this time
+        if (spin > estimate) {
+          estimate += (spin - estimate + 7) / 8;
+        } else {
+          estimate -= (estimate - spin) / 8;
+        }
+
+        return true;
+      }
+    }
+
+    estimate /= 2;
+    return false;
+  }
+
+private:
+  /** the calling thread's (moving) average of the spins required for a slot to be written */
+  static std::size_t& estimated_spins() noexcept {
+    thread_local std::size_t estimate = 8;
+    return estimate;
+  }
+};
+
+/** Elements remaining in the queue upon its destruction are leaked (default). */
+struct no_deleter {
+  using policy_category = detail::deleter_policy_tag;
+  static constexpr bool enabled = false;
+};
+
+/**
+ * Elements remaining in the queue upon its destruction are handed to a default constructed
+ * `Deleter` (e.g., `std::default_delete<T>`) in FIFO order, which must not throw.
+ */
+template <typename Deleter>
+struct deleter {
+  using policy_category = detail::deleter_policy_tag;
+  using type = Deleter;
+  static constexpr bool enabled = true;
+};
+
+/**
+ * The head and tail (and the cached tail pointer) are each aligned to a separate cache line (pair),
+ * so producers and consumers don't interfere with each other (default).
+ */
+struct cache_line_padding {
+  using policy_category = detail::padding_policy_tag;
+  static constexpr std::size_t align = CACHE_LINE_ALIGN;
+};
+
+/**
+ * The head and tail are not padded, which reduces the size of each queue (e.g., for many mostly
+ * idle queues), but lets producers and consumers contend for the same cache line.
+ */
+struct no_padding {
+  using policy_category = detail::padding_policy_tag;
+  static constexpr std::size_t align = alignof(std::uint64_t);
+};
+
+/**
+ * Consumers can't block or suspend coroutines until elements become available (default), so
+ * enqueue operations never have to check for (and wake up) waiting consumers.
+ */
+struct no_blocking {
+  using policy_category = detail::blocking_policy_tag;
+  static constexpr bool enabled = false;
+};
+
+/**
+ * Consumers may block in `wait_dequeue` (and `wait_dequeue_for`) or suspend coroutines in
+ * `async_dequeue`, so every enqueue operation is followed by a full fence and the loads of the
+ * waiter counts, wake-ups are only issued while consumers are actually waiting.
+ */
+struct blocking {
+  using policy_category = detail::blocking_policy_tag;
+  static constexpr bool enabled = true;
+};
+
+/** All nodes have the same number of slots and the first node is allocated upfront (default). */
+struct fixed_nodes {
+  using policy_category = detail::growth_policy_tag;
+  static constexpr bool enabled = false;
+  static constexpr bool shrink = false;
+
+  template <std::size_t NodeSize>
+  static constexpr std::size_t min_size = NodeSize;
+};
+
+/**
+ * No node is allocated before the first enqueue operation, the first node has `MinSize` slots and
+ * each appended node has twice as many slots as its predecessor (up to the queue's node size), so
+ * queues, which never hold many elements, never allocate large nodes.
+ *
+ * If `Shrink` is set, the next appended node has `MinSize` slots again after the queue has been
+ * found empty, which returns mostly idle queues to a small footprint, but also keeps nodes small
+ * if consumers frequently drain the queue under load.
+ * Node sizes are read from each node, which adds a (mostly cached) load to the fast path, and the
+ * nodes must not require more than cache line alignment (e.g., with `high_bit_tagging`).
+ */
+template <std::size_t MinSize = 8, bool Shrink = true>
+struct growing_nodes {
+  static_assert(std::has_single_bit(MinSize), "MinSize must be a power of 2");
+  using policy_category = detail::growth_policy_tag;
+  static constexpr bool enabled = true;
+  static constexpr bool shrink = Shrink;
+
+  template <std::size_t NodeSize>
+  static constexpr std::size_t min_size = MinSize;
+};
+
+/**
+ * Nodes (and elements) are referenced through their addresses and allocated from the queue's memory
+ * resource (default).
+ */
+struct absolute_addressing {
+  using policy_category = detail::addressing_policy_tag;
+  static constexpr bool relative = false;
+  using arena_type = void;
+
+  template <typename T>
+  using pointer_t = T*;
+  template <typename T>
+  using atomic_ptr_t = std::atomic<T*>;
+  template <typename MarkedPtr>
+  using atomic_marked_t = std::atomic<std::uintptr_t>;
+};
+
+/**
+ * All pointers stored in the queue and its nodes are replaced by their distances from their own
+ * address (and pointer elements by their distances from the queue), which are the same in every
+ * process mapping the shared memory segment containing the queue, its nodes and all elements, even
+ * at different addresses (see `loo::shm_queue`).
+ *
+ * Nodes are allocated from an `Arena` (through `allocate(bytes, align)` and `deallocate(block,
+ * bytes)`) in the same segment, which is passed to the queue's constructor, and the index is stored
+ * in the high bits of the relative head and tail node pointers, which requires `high_bit_tagging`.
+ * Consumers can't block, since waiting threads and coroutines are local to their process.
+ */
+template <typename Arena>
+struct segment_addressing {
+  using policy_category = detail::addressing_policy_tag;
+  static constexpr bool relative = true;
+  using arena_type = Arena;
+
+  template <typename T>
+  using pointer_t = detail::relative_ptr_t<T>;
+  template <typename T>
+  using atomic_ptr_t = detail::atomic_relative_ptr_t<T>;
+  template <typename MarkedPtr>
+  using atomic_marked_t = detail::atomic_relative_marked_t<MarkedPtr>;
+};
+}
+
+#endif /* LOO_QUEUE_POLICY_HPP */
@@ -0,0 +1,111 @@
+#ifndef LOO_QUEUE_PRIORITY_QUEUE_HPP
+#define LOO_QUEUE_PRIORITY_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+#include "looqueue/align.hpp"
+#include "looqueue/queue.hpp"
+
+namespace loo {
+/**
+ * A multi-priority queue, which maintains one `loo::queue` per priority lane (lane 0 having the
+ * highest priority) and dequeues from the first non-empty lane.
+ *
+ * A summary word stores one bit per lane, which is set while the lane may be non-empty, so
+ * consumers skip empty lanes with a single load instead of probing (and writing to) the head of
+ * each lane and a dequeue from an entirely empty queue requires no RMW at all.
+ * Producers only read the summary unless they find their lane's bit cleared, consumers only clear
+ * a bit after having found the lane empty, so the summary is rarely written under load.
+ *
+ * Ordering guarantees: Each lane is a linearizable FIFO queue, but there is no order between
+ * elements in different lanes, e.g., a dequeue may return an element of a lower priority lane
+ * while an element is concurrently enqueued to a higher priority lane.
+ */
+template <
+    typename T,
+    std::size_t Lanes,
+    std::size_t NodeSize = DEFAULT_NODE_SIZE,
+    typename... Policies
+>
+class priority_queue {
+  static_assert(Lanes > 0 && Lanes <= 64, "the number of lanes must be in [1, 64]");
+
+public:
+  using queue_type  = queue<T, NodeSize, Policies...>;
+  using value_type  = typename queue_type::value_type;
+  using result_type = typename queue_type::result_type;
+
+  /** the number of priority lanes */
+  static constexpr std::size_t LANES = Lanes;
+  /** any thread may access any lane, so the same limits as for each individual lane apply */
+  static constexpr std::size_t MAX_PRODUCER_THREADS = queue_type::MAX_PRODUCER_THREADS;
+  static constexpr std::size_t MAX_CONSUMER_THREADS = queue_type::MAX_CONSUMER_THREADS;
+
+  /** constructor (default) */
+  priority_queue() : priority_queue(queue_options{}) {}
+  /** constructor w/ the options for each individual lane */
+  explicit priority_queue(const queue_options& options) {
+    for (auto& lane : this->m_lanes) {
+      lane = std::make_unique<queue_type>(options);
+    }
+  }
+
+  /** enqueue an element to the back of the given lane (must be less than `LANES`) */
+  void enqueue(std::size_t lane, value_type elem) {
+    this->m_lanes[lane]->enqueue(elem);
+    // the fence orders this load after the insertion, so either this thread observes a
+    // concurrently cleared bit or the clearing consumer's re-check finds the element
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bit = std::uint64_t{ 1 } << lane;
+    if ((this->m_summary.load(std::memory_order_relaxed) & bit) == 0) [[unlikely]] {
+      this->m_summary.fetch_or(bit, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * dequeue an element from the front of the highest priority (lowest index) lane, which is not
+   * empty (`nullptr` or empty if all lanes are empty)
+   */
+  result_type dequeue() {
+    auto summary = this->m_summary.load(std::memory_order_relaxed);
+    while (summary != 0) {
+      const auto lane = std::countr_zero(summary);
+      const auto bit = std::uint64_t{ 1 } << lane;
+      auto& queue = *this->m_lanes[lane];
+      if (auto res = queue.dequeue(); res) {
+        return res;
+      }
+
+      // the lane appears empty, so its bit is cleared and the lane is checked again, which finds
+      // any element whose producer may have missed the cleared bit (see `enqueue`)
+      this->m_summary.fetch_and(~bit, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (auto res = queue.dequeue(); res) {
+        // further elements may follow the re-checked one
+        this->m_summary.fetch_or(bit, std::memory_order_relaxed);
+        return res;
+      }
+
+      summary &= ~bit;
+    }
+
+    return result_type{};
+  }
+
+  /** returns the summary word, in which the bit of each lane, which may be non-empty, is set */
+  [[nodiscard]] std::uint64_t summary() const noexcept {
+    return this->m_summary.load(std::memory_order_relaxed);
+  }
+
+private:
+  /** the summary word is only rarely written, so it does not share a cache line with any lane */
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::uint64_t>  m_summary{ 0 };
+  std::array<std::unique_ptr<queue_type>, Lanes>        m_lanes{};
+};
+}
+
+#endif /* LOO_QUEUE_PRIORITY_QUEUE_HPP */
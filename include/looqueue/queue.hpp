@@ -1,53 +1,158 @@
 #ifndef LOO_QUEUE_HPP
 #define LOO_QUEUE_HPP
 
-#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include "looqueue/queue_fwd.hpp"
+#include "looqueue/detail/backoff.hpp"
+#include "looqueue/detail/dequeue_awaitable.hpp"
 #include "looqueue/detail/node.hpp"
+#include "looqueue/detail/trace.hpp"
 
 namespace loo {
-template <typename T>
-queue<T>::queue() {
-  // initially head and tail point at the same node
-  auto head = new(std::align_val_t{ NODE_ALIGN }) node_t();
-  this->m_head.store(reinterpret_cast<slot_t>(head), relaxed);
-  this->m_tail.store(reinterpret_cast<slot_t>(head), relaxed);
-  this->m_curr_tail.store(head, relaxed);
+template <typename T, std::size_t NodeSize, typename... Policies>
+queue<T, NodeSize, Policies...>::queue(const queue_options& options) requires (!RELATIVE) :
+  m_resource{ options.resource == nullptr ? std::pmr::new_delete_resource() : options.resource },
+  m_pool_capacity{
+      options.resource == nullptr ? options.pool_capacity.value_or(DEFAULT_POOL_CAPACITY) : 0
+  },
+  // the head node may be partially consumed, so one additional node is required to guarantee that
+  // at least `capacity` elements can be stored
+  m_max_slots{
+      options.capacity == 0 ? 0 : ((options.capacity + NODE_SIZE - 1) / NODE_SIZE + 1) * NODE_SIZE
+  }
+{
+  this->init_head();
 }
 
-template <typename T>
-queue<T>::~queue() noexcept {
+template <typename T, std::size_t NodeSize, typename... Policies>
+queue<T, NodeSize, Policies...>::~queue() noexcept {
+  if constexpr (deleter_t::enabled) {
+    typename deleter_t::type deleter{};
+    this->consume_all(deleter);
+  }
+
   // de-allocate all remaining nodes in the queue
   auto curr = marked_ptr_t(this->m_head.load(relaxed)).decompose_ptr();
   while (curr != nullptr) {
     auto next = curr->next.load(relaxed);
-    delete curr;
+    if (!this->is_sentinel(curr)) {
+      this->dealloc_node(curr);
+    }
+
     curr = next;
   }
+
+  if constexpr (spare_t::enabled) {
+    if (auto spare = this->m_spare.node.load(relaxed); spare != nullptr) {
+      this->dealloc_node(spare);
+    }
+  }
+
+  // releases all retained nodes to the upstream resource
+  delete this->m_pool.load(relaxed);
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::enqueue(queue::value_type elem) {
+  codec_t::validate(elem);
+  this->enqueue_impl(this->encode(elem), false);
+  this->notify_waiters();
 }
 
-template <typename T>
-void queue<T>::enqueue(queue::pointer elem) {
-  // validate `elem` argument (must not be null and 4 byte aligned so it can store 2 bits)
-  if (elem == nullptr) [[unlikely]] {
-    throw std::invalid_argument("enqueue element must not be null");
+template <typename T, std::size_t NodeSize, typename... Policies>
+bool queue<T, NodeSize, Policies...>::try_enqueue(queue::value_type elem) {
+  codec_t::validate(elem);
+  if (this->is_bounded()) {
+    // if the tail node is full and no further node may be appended, the operation fails without
+    // incrementing the enqueue index, which requires no read-modify-write operations
+    const auto [tail, idx] = marked_ptr_t(this->m_tail.load(relaxed)).decompose();
+    if (idx >= this->max_node_size(tail) && this->m_slot_count.load(acquire) >= this->m_max_slots) {
+      return false;
+    }
+  }
+
+  if (!this->enqueue_impl(this->encode(elem), this->is_bounded())) {
+    return false;
+  }
+
+  this->notify_waiters();
+  return true;
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+typename queue<T, NodeSize, Policies...>::result_type
+queue<T, NodeSize, Policies...>::wait_dequeue_impl(
+    const std::chrono::steady_clock::time_point* deadline
+) {
+  while (true) {
+    // spin for a bounded number of attempts, which avoids the cost of parking (and waking) in the
+    // common case of elements arriving shortly after
+    for (std::size_t spin = 0; spin < WAIT_SPIN_COUNT; ++spin) {
+      if (auto res = this->try_dequeue(); codec_t::has_value(res)) {
+        return res;
+      }
+
+      detail::cpu_relax();
+    }
+
+    // announce this thread as waiter and re-check the queue, any element enqueued after this
+    // re-check is guaranteed to wake up this thread (see detail::event_count)
+    auto& parked = this->m_waiters.parked;
+    const auto key = parked.prepare_wait();
+    if (auto res = this->dequeue(); codec_t::has_value(res)) {
+      parked.cancel_wait();
+      return res;
+    }
+
+    if (deadline == nullptr) {
+      parked.wait(key);
+      continue;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= *deadline) {
+      parked.cancel_wait();
+      return codec_t::empty();
+    }
+
+    const auto timeout = std::chrono::nanoseconds{ *deadline - now };
+    if (!parked.wait(key, &timeout)) {
+      // one final attempt, an element may have been enqueued just before the timeout expired
+      return this->dequeue();
+    }
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+bool queue<T, NodeSize, Policies...>::enqueue_impl(queue::slot_t elem, bool bounded) {
+  if constexpr (SINGLE_PRODUCER) {
+    return this->enqueue_single_producer(elem, bounded);
   }
 
   while (true) {
     // increment the enqueue index, retrieve the tail pointer and previous index value
     // see PROOF.md regarding the (im)possibility of overflows
-    const auto curr = marked_ptr_t(this->m_tail.fetch_add(1, acquire));
+    const auto curr = marked_ptr_t(this->m_tail.fetch_add(marked_ptr_t::INCREMENT, acquire));
     const auto [tail, idx] = curr.decompose();
 
-    if (idx < NODE_SIZE) [[likely]]  {
+    if (idx < tail->size()) [[likely]]  {
       // ** fast path ** write access to the slot at tail.idx was uniquely reserved write the `elem`
       // bits into the slot (unique access ensures this is done exactly once)
-      const auto state = tail->slots[idx].fetch_add(reinterpret_cast<slot_t>(elem), release);
+      const auto state = tail->slots()[idx].fetch_add(elem, release);
+      if (idx == SPARE_WATERMARK) [[unlikely]] {
+        this->prepare_spare_node();
+      }
+
       if (state <= node_t::slot_flags_t::RESUME) [[likely]] {
         // no READ bit is set, RESUME may or may not be set - the element was successfully inserted
         // if the RESUME bit is set, the corresponding dequeue operation will act accordingly.
-        return;
+        return true;
       } else if (state == (node_t::slot_flags_t::READER | node_t::slot_flags_t::RESUME)) {
         // READ and RESUME are set, so this must be the final operation visiting this slot hence the
         // slot must be abandoned (dequeue finished too early) and `try_reclaim` must be resumed
@@ -56,72 +161,410 @@ void queue<T>::enqueue(queue::pointer elem) {
 
       // only the READ bit is set so the slot must be abandoned and both operations must retry on
       // another slot
+      LOO_TRACE(enqueue_abandon, tail, idx);
       continue;
     } else {
       // ** slow path ** no free slot is available in this node, so a new node has to be appended
       // that attempts to directly insert `elem` in the newly appended node's first slot and the
       // enqueue procedure is completed on success; in any case `tail` points at some successor node
       // when this sub-procedure completes
-      switch (this->try_advance_tail(elem, tail)) {
-        case detail::advance_tail_res_t::ADVANCED_AND_INSERTED: return;
+      this->m_stats.increment(queue_event::ENQUEUE_SLOW_PATH);
+      switch (this->try_advance_tail(elem, tail, bounded)) {
+        case detail::advance_tail_res_t::ADVANCED_AND_INSERTED: return true;
         case detail::advance_tail_res_t::ADVANCED: continue;
+        case detail::advance_tail_res_t::QUEUE_FULL: return false;
       }
     }
   }
 }
 
-template <typename T>
-typename queue<T>::pointer queue<T>::dequeue() {
+template <typename T, std::size_t NodeSize, typename... Policies>
+template <std::forward_iterator It>
+void queue<T, NodeSize, Policies...>::enqueue_bulk(It first, It last) {
+  // validate all elements before inserting any of them
+  std::for_each(first, last, [](const value_type& elem) { codec_t::validate(elem); });
+
+  const auto total = static_cast<std::size_t>(std::distance(first, last));
+  auto remaining = total;
+  while (remaining != 0) {
+    auto curr = marked_ptr_t(this->m_tail.load(relaxed));
+    const auto [tail, idx] = curr.decompose();
+    // with multiple producers, the tail node may already be reclaimed, so only a lower bound of its
+    // size is known before any of its slots have been reserved (growing nodes only)
+    const auto size = SINGLE_PRODUCER ? tail->size() : this->min_node_size(tail);
+
+    if (idx >= size) {
+      // ** slow path ** the tail node is already full (or its size is unknown), so the next element
+      // is inserted through the regular procedure, which appends a new node or helps advancing the
+      // tail
+      this->enqueue_impl(this->encode(*first), false);
+      ++first;
+      --remaining;
+      continue;
+    }
+
+    // reserve as many slots as the tail node has left (at most one per element), a CAS is used
+    // instead of a FAA, since the reservation must never extend beyond the node's final slot,
+    // which would violate the overflow bounds (see PROOF.md) and the slow path ops count
+    auto count = std::min(remaining, size - idx);
+    if constexpr (!SINGLE_PRODUCER) {
+      if (!this->m_tail.compare_exchange_weak(
+          curr.as_uintptr(), curr.to_uintptr() + count * marked_ptr_t::INCREMENT, acquire, relaxed
+      )) {
+        continue;
+      }
+
+      if constexpr (GROWING) {
+        // the reserved slots have not been written yet, so the node can't be reclaimed and the
+        // reservation can be extended up to the node's actual size
+        const auto extra = std::min(remaining - count, tail->size() - idx - count);
+        auto expected = curr.to_uintptr() + count * marked_ptr_t::INCREMENT;
+        if (extra != 0 && this->m_tail.compare_exchange_strong(
+            expected, expected + extra * marked_ptr_t::INCREMENT, acquire, relaxed
+        )) {
+          count += extra;
+        }
+      }
+    }
+
+    // ** fast path ** write access to all slots in [idx, idx + count) was uniquely reserved, write
+    // the elements in order, slots that have to be abandoned are skipped and the element is written
+    // to the following slot instead (or left for the next reservation)
+    for (auto slot = idx; slot < idx + count; ++slot) {
+      const auto elem = this->encode(*first);
+      if constexpr (SINGLE_PRODUCER && SINGLE_CONSUMER) {
+        // the consumer never visits unpublished slots (see `enqueue_single_producer`)
+        tail->slots()[slot].store(elem, relaxed);
+        ++first;
+        --remaining;
+        continue;
+      }
+
+      const auto state = tail->slots()[slot].fetch_add(elem, release);
+      if (state <= node_t::slot_flags_t::RESUME) [[likely]] {
+        ++first;
+        --remaining;
+        continue;
+      } else if (state == (node_t::slot_flags_t::READER | node_t::slot_flags_t::RESUME)) {
+        tail->try_reclaim(slot + 1);
+      }
+
+      LOO_TRACE(enqueue_abandon, tail, slot);
+    }
+
+    if constexpr (SINGLE_PRODUCER) {
+      // a single producer publishes all slots at once, only after they have been written
+      this->m_tail.store(curr.to_uintptr() + count * marked_ptr_t::INCREMENT, release);
+    }
+
+    if (idx <= SPARE_WATERMARK && SPARE_WATERMARK < idx + count) [[unlikely]] {
+      this->prepare_spare_node();
+    }
+  }
+
+  if (total != 0) {
+    this->notify_waiters(static_cast<std::uint32_t>(std::min<std::size_t>(total, UINT32_MAX)));
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+typename queue<T, NodeSize, Policies...>::result_type
+queue<T, NodeSize, Policies...>::dequeue() {
+  if constexpr (SINGLE_CONSUMER) {
+    return this->dequeue_single_consumer();
+  }
+
   while (true) {
     // check if the queue is empty
     if (this->is_empty()) {
-      return nullptr;
+      return codec_t::empty();
     }
 
     // increment the dequeue index, retrieve the head pointer and previous index value see PROOF.md
     // regarding the (im)possibility of overflows
-    const auto curr = marked_ptr_t(this->m_head.fetch_add(1, acquire));
+    const auto curr = marked_ptr_t(this->m_head.fetch_add(marked_ptr_t::INCREMENT, acquire));
     const auto [head, idx] = curr.decompose();
 
-    if (idx < NODE_SIZE) [[likely]] {
+    if (idx < head->size()) [[likely]] {
       // ** fast path ** read access to the slot at tail.idx was uniquely reserved
-      // set the READ bit in the slot (unique access ensures this is done exactly once)
-      const auto state = head->slots[idx].fetch_add(node_t::slot_flags_t::READER, acquire);
-      // extract the pointer bits from the retrieved value
-      const auto res = reinterpret_cast<pointer>(state & node_t::slot_flags_t::ELEM_MASK);
-
-      // check the extracted pointer bits, if the result is null, the deque thread must have set the
-      // READ bit before the pointer bits have been set by the corresponding enqueue operation, yet
-      if (res != nullptr) [[likely]] {
+      // set the READ bit in the slot (unique access ensures this is done exactly once), which may
+      // be deferred by the wait policy until the slot's producer has written it
+      this->await_slot(head, idx);
+      const auto state = head->slots()[idx].fetch_add(node_t::slot_flags_t::READER, acquire);
+      // extract the element bits from the retrieved value
+      const auto bits = state & node_t::slot_flags_t::ELEM_MASK;
+
+      // check the extracted element bits, if none are set, the deque thread must have set the READ
+      // bit before the element bits have been set by the corresponding enqueue operation, yet
+      if (bits != 0) [[likely]] {
         if ((state & node_t::slot_flags_t::RESUME) != 0) [[unlikely]] {
           head->try_reclaim(idx + 1);
         }
 
-        return res;
+        return this->decode(bits);
       }
 
       // the slot must be abandoned
+      this->m_stats.increment(queue_event::ABANDONED_SLOT);
+      LOO_TRACE(dequeue_abandon, head, idx);
       continue;
     } else {
       // ** slow path ** the current head node has been fully consumed and must
       // be replaced by its successor, if there is one
+      this->m_stats.increment(queue_event::DEQUEUE_SLOW_PATH);
       switch (this->try_advance_head(curr, head, idx)) {
         case detail::advance_head_res_t::ADVANCED:    continue;
-        case detail::advance_head_res_t::QUEUE_EMPTY: return nullptr;
+        case detail::advance_head_res_t::QUEUE_EMPTY: return codec_t::empty();
+      }
+    }
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+typename queue<T, NodeSize, Policies...>::result_type
+queue<T, NodeSize, Policies...>::try_dequeue() {
+  // a single consumer checks for an available slot w/o any RMW anyways
+  if (!SINGLE_CONSUMER && this->looks_empty()) {
+    return codec_t::empty();
+  }
+
+  return this->dequeue();
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+template <typename Rep, typename Period>
+typename queue<T, NodeSize, Policies...>::result_type
+queue<T, NodeSize, Policies...>::poll_dequeue_for(
+    const std::chrono::duration<Rep, Period>& timeout
+) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  detail::exponential_backoff backoff{ POLL_MAX_SPINS };
+  while (true) {
+    if (auto res = this->try_dequeue(); codec_t::has_value(res)) {
+      return res;
+    }
+
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return codec_t::empty();
+    }
+
+    backoff.spin();
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+template <std::output_iterator<typename queue<T, NodeSize, Policies...>::value_type> OutIt>
+std::size_t queue<T, NodeSize, Policies...>::dequeue_bulk(OutIt out, std::size_t max) {
+  auto write = [&out](value_type elem) {
+    *out++ = elem;
+  };
+
+  return this->consume_impl(write, max);
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+template <typename Fn>
+std::size_t queue<T, NodeSize, Policies...>::consume_impl(Fn& fn, std::size_t max) {
+  std::size_t count = 0;
+  while (count < max) {
+    // estimate the number of available elements from both index values, all slots that have been
+    // reserved by enqueue operations are considered available
+    auto curr = marked_ptr_t(this->m_head.load(relaxed));
+    const auto [head, deq_idx] = curr.decompose();
+    // with multiple consumers, the head node may already be reclaimed (see `enqueue_bulk`)
+    const auto size = SINGLE_CONSUMER ? head->size() : this->min_node_size(head);
+
+    if (deq_idx >= size) {
+      // ** slow path ** the head node has been fully consumed (or its size is unknown), so the next
+      // element is dequeued through the regular procedure, which advances the head or determines
+      // the queue to be empty
+      const auto res = this->dequeue();
+      if (!codec_t::has_value(res)) {
+        break;
+      }
+
+      fn(codec_t::unwrap(res));
+      ++count;
+      continue;
+    }
+
+    const auto [tail, enq_idx] = marked_ptr_t(this->m_tail.load(acquire)).decompose();
+    std::size_t available = size - deq_idx;
+    if (head == tail) {
+      if (enq_idx <= deq_idx) {
+        break;
+      }
+
+      available = std::min(enq_idx, size) - deq_idx;
+    }
+
+    // reserve the available slots (at most `max`) in the head node, as with `enqueue_bulk`, a CAS
+    // is used so the reservation never extends beyond the node's final slot
+    auto reserve = std::min(max - count, available);
+    if constexpr (SINGLE_CONSUMER) {
+      this->m_head.store(curr.to_uintptr() + reserve * marked_ptr_t::INCREMENT, relaxed);
+    } else if (!this->m_head.compare_exchange_weak(
+        curr.as_uintptr(), curr.to_uintptr() + reserve * marked_ptr_t::INCREMENT, acquire, relaxed
+    )) {
+      continue;
+    } else if constexpr (GROWING) {
+      // the reserved slots have not been visited yet, so the node can't be reclaimed and the
+      // reservation can be extended up to the node's actual size (see `enqueue_bulk`)
+      const auto limit = head == tail ? std::min(enq_idx, head->size()) : head->size();
+      const auto extra = std::min(max - count - reserve, limit - deq_idx - reserve);
+      auto expected = curr.to_uintptr() + reserve * marked_ptr_t::INCREMENT;
+      if (extra != 0 && this->m_head.compare_exchange_strong(
+          expected, expected + extra * marked_ptr_t::INCREMENT, acquire, relaxed
+      )) {
+        reserve += extra;
+      }
+    }
+
+    // ** fast path ** read access to all slots in [deq_idx, deq_idx + reserve) was uniquely
+    // reserved, set the READ bit in each slot, empty slots are abandoned just as in `dequeue`
+    for (auto idx = deq_idx; idx < deq_idx + reserve; ++idx) {
+      this->await_slot(head, idx);
+      const auto state = head->slots()[idx].fetch_add(node_t::slot_flags_t::READER, acquire);
+      const auto bits = state & node_t::slot_flags_t::ELEM_MASK;
+
+      if (bits != 0) [[likely]] {
+        if ((state & node_t::slot_flags_t::RESUME) != 0) [[unlikely]] {
+          head->try_reclaim(idx + 1);
+        }
+
+        fn(this->decode(bits));
+        ++count;
+      } else {
+        this->m_stats.increment(queue_event::ABANDONED_SLOT);
+        LOO_TRACE(dequeue_abandon, head, idx);
+      }
+    }
+  }
+
+  return count;
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+bool queue<T, NodeSize, Policies...>::enqueue_single_producer(queue::slot_t elem, bool bounded) {
+  while (true) {
+    // only the calling thread modifies the tail, so it always loads its own latest value
+    const auto curr = marked_ptr_t(this->m_tail.load(relaxed));
+    const auto [tail, idx] = curr.decompose();
+
+    if (idx < tail->size()) [[likely]] {
+      // ** fast path ** the slot is written BEFORE the incremented index is published, so a single
+      // consumer (which checks the index first) never finds it empty and no RMW is required
+      if constexpr (SINGLE_CONSUMER) {
+        tail->slots()[idx].store(elem, relaxed);
+        this->m_tail.store(curr.to_uintptr() + marked_ptr_t::INCREMENT, release);
+        if (idx == SPARE_WATERMARK) [[unlikely]] {
+          this->prepare_spare_node();
+        }
+
+        return true;
+      }
+
+      // multiple consumers increment the dequeue index before checking, so they may still visit
+      // the slot before it is written, which is resolved just as in `enqueue_impl`
+      const auto state = tail->slots()[idx].fetch_add(elem, release);
+      this->m_tail.store(curr.to_uintptr() + marked_ptr_t::INCREMENT, release);
+      if (idx == SPARE_WATERMARK) [[unlikely]] {
+        this->prepare_spare_node();
+      }
+
+      if (state <= node_t::slot_flags_t::RESUME) [[likely]] {
+        return true;
+      } else if (state == (node_t::slot_flags_t::READER | node_t::slot_flags_t::RESUME)) {
+        tail->try_reclaim(idx + 1);
+      }
+
+      LOO_TRACE(enqueue_abandon, tail, idx);
+      continue;
+    } else {
+      // ** slow path ** the index never exceeds the node size, since it is only incremented after
+      // a slot has been written
+      this->m_stats.increment(queue_event::ENQUEUE_SLOW_PATH);
+      return this->append_node_single_producer(elem, tail, bounded);
+    }
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+typename queue<T, NodeSize, Policies...>::result_type
+queue<T, NodeSize, Policies...>::dequeue_single_consumer() {
+  while (true) {
+    // only the calling thread modifies the head, so it always loads its own latest value
+    const auto curr = marked_ptr_t(this->m_head.load(relaxed));
+    const auto [head, idx] = curr.decompose();
+
+    if (idx < head->size()) [[likely]] {
+      // check for an available slot BEFORE incrementing the index, so the queue's emptiness is
+      // determined without any RMW and the index never exceeds the node size
+      const auto [tail, enq_idx] = marked_ptr_t(this->m_tail.load(acquire)).decompose();
+      if (head == tail && enq_idx <= idx) {
+        this->mark_idle();
+        return codec_t::empty();
+      }
+
+      this->m_head.store(curr.to_uintptr() + marked_ptr_t::INCREMENT, relaxed);
+      if constexpr (SINGLE_PRODUCER) {
+        // ** fast path ** a single producer publishes each slot only after writing it (see
+        // `enqueue_single_producer`), so it can't be empty
+        const auto bits = head->slots()[idx].load(acquire) & node_t::slot_flags_t::ELEM_MASK;
+        return this->decode(bits);
+      }
+
+      // ** fast path ** multiple producers increment the enqueue index before writing the slot,
+      // so it may still have to be abandoned just as in `dequeue`
+      this->await_slot(head, idx);
+      const auto state = head->slots()[idx].fetch_add(node_t::slot_flags_t::READER, acquire);
+      const auto bits = state & node_t::slot_flags_t::ELEM_MASK;
+
+      if (bits != 0) [[likely]] {
+        if ((state & node_t::slot_flags_t::RESUME) != 0) [[unlikely]] {
+          head->try_reclaim(idx + 1);
+        }
+
+        return this->decode(bits);
+      }
+
+      this->m_stats.increment(queue_event::ABANDONED_SLOT);
+      LOO_TRACE(dequeue_abandon, head, idx);
+      continue;
+    } else {
+      // ** slow path ** the current head node has been fully consumed
+      this->m_stats.increment(queue_event::DEQUEUE_SLOW_PATH);
+      if (!this->advance_head_single_consumer(head)) {
+        this->mark_idle();
+        return codec_t::empty();
       }
     }
   }
 }
 
+template <typename T, std::size_t NodeSize, typename... Policies>
+typename queue<T, NodeSize, Policies...>::value_type
+queue<T, NodeSize, Policies...>::wait_dequeue() requires BLOCKING {
+  return codec_t::unwrap(this->wait_dequeue_impl(nullptr));
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+template <coroutine_executor Executor>
+typename queue<T, NodeSize, Policies...>::template dequeue_awaitable<Executor>
+queue<T, NodeSize, Policies...>::async_dequeue(Executor& executor)
+requires (BLOCKING && !SINGLE_CONSUMER) {
+  return dequeue_awaitable<Executor>{ *this, executor };
+}
+
 /********** private static functions **************************************************************/
 
-template <typename T>
-bool queue<T>::bounded_cas_loop(
-  queue::atomic_slot_t& node,
-  queue::marked_ptr_t&  expected,
-  queue::marked_ptr_t   desired,
-  const queue::node_t*  old_node,
-  std::memory_order     order
+template <typename T, std::size_t NodeSize, typename... Policies>
+bool queue<T, NodeSize, Policies...>::bounded_cas_loop(
+  queue::atomic_marked_t& node,
+  queue::marked_ptr_t&    expected,
+  queue::marked_ptr_t     desired,
+  const queue::node_t*    old_node,
+  std::memory_order       order
 ) {
   // this loop attempts to exchange the expected (pointer, tag) pair with the desired pair,
   // the expected value is updated after each unsuccessful invocation so it always contains the
@@ -139,8 +582,112 @@ bool queue<T>::bounded_cas_loop(
 
 /********** private methods ***********************************************************************/
 
-template <typename T>
-bool queue<T>::is_empty() noexcept {
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::init_head() {
+  static_assert(sizeof(node_t) <= detail::NODE_HEADER_SIZE, "node header exceeds its storage");
+  node_t* head;
+  if constexpr (GROWING) {
+    // the embedded initial node has no slots, so the first enqueue operation appends a node
+    head = new(this->m_growth.sentinel) node_t(this, 0);
+  } else {
+    head = this->alloc_node(NODE_SIZE);
+  }
+
+  // initially head and tail point at the same node
+  this->m_head.store(reinterpret_cast<slot_t>(head), relaxed);
+  this->m_tail.store(reinterpret_cast<slot_t>(head), relaxed);
+  this->m_curr_tail.store(head, relaxed);
+  this->m_slot_count.store(head->size(), relaxed);
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+typename queue<T, NodeSize, Policies...>::slot_t
+queue<T, NodeSize, Policies...>::encode(const queue::value_type& elem) const noexcept {
+  if constexpr (RELATIVE && std::is_pointer_v<value_type>) {
+    // the element and the queue are in the same segment, so their distance is the same in every
+    // process, both are at least 4-byte aligned, so the state bits remain unset
+    return codec_t::encode(elem) - reinterpret_cast<slot_t>(this);
+  } else {
+    return codec_t::encode(elem);
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+typename queue<T, NodeSize, Policies...>::value_type
+queue<T, NodeSize, Policies...>::decode(queue::slot_t bits) const noexcept {
+  if constexpr (RELATIVE && std::is_pointer_v<value_type>) {
+    return codec_t::decode(bits + reinterpret_cast<slot_t>(this));
+  } else {
+    return codec_t::decode(bits);
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::notify_waiters(std::uint32_t count) {
+  if constexpr (BLOCKING) {
+    this->m_waiters.parked.notify(count);
+    // the fence in `notify` orders this load after the preceding enqueue operation, so either this
+    // thread observes a coroutine registered in `suspend_async_waiter` or its re-check observes the
+    // enqueued element
+    if (this->m_waiters.async.load(relaxed) != nullptr) [[unlikely]] {
+      this->resume_async_waiters();
+    }
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::suspend_async_waiter(queue::async_waiter_t* waiter) {
+  auto& async = this->m_waiters.async;
+  waiter->next = async.load(relaxed);
+  while (!async.compare_exchange_weak(waiter->next, waiter, seq_cst, relaxed)) {}
+
+  // re-check the queue, an element may have been enqueued before the waiter was registered
+  this->resume_async_waiters();
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::resume_async_waiters() {
+  auto& async = this->m_waiters.async;
+  while (true) {
+    // all waiters are removed at once, which avoids the ABA problem of popping single waiters
+    auto waiters = async.exchange(nullptr, seq_cst);
+    while (waiters != nullptr) {
+      auto res = this->dequeue();
+      if (!codec_t::has_value(res)) {
+        break;
+      }
+
+      // the waiter may be destroyed as soon as it is scheduled
+      auto waiter = waiters;
+      waiters = waiter->next;
+      waiter->result = res;
+      waiter->schedule(waiter);
+    }
+
+    if (waiters == nullptr) {
+      return;
+    }
+
+    // the queue is empty, so the remaining waiters are registered again
+    auto last = waiters;
+    while (last->next != nullptr) {
+      last = last->next;
+    }
+
+    last->next = async.load(relaxed);
+    while (!async.compare_exchange_weak(last->next, waiters, seq_cst, relaxed)) {}
+
+    // an element enqueued concurrently (while no waiters were registered) may have been missed by
+    // its producer, in which case the procedure is repeated
+    std::atomic_thread_fence(seq_cst);
+    if (this->is_empty()) {
+      return;
+    }
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+bool queue<T, NodeSize, Policies...>::is_empty() noexcept {
   // using a read-modify-write operation that does not actually modify the value but acquires
   // ownership of the variable's cache-line, making the subsequent FAA potentially more efficient
   // (at least on x86)
@@ -151,7 +698,8 @@ bool queue<T>::is_empty() noexcept {
       this->m_curr_tail.compare_exchange_strong(curr_tail, tail, release, relaxed);
     }
 
-    if (head == tail && (deq_idx >= NODE_SIZE || enq_idx <= deq_idx)) {
+    if (head == tail && (deq_idx >= this->max_node_size(head) || enq_idx <= deq_idx)) {
+      this->mark_idle();
       return true;
     }
   }
@@ -159,8 +707,239 @@ bool queue<T>::is_empty() noexcept {
   return false;
 }
 
-template <typename T>
-detail::advance_head_res_t queue<T>::try_advance_head(
+template <typename T, std::size_t NodeSize, typename... Policies>
+bool queue<T, NodeSize, Policies...>::looks_empty() const noexcept {
+  // the cached tail is rarely written, so the tail is only loaded if the head has caught up to it
+  const auto [head, deq_idx] = marked_ptr_t(this->m_head.load(relaxed)).decompose();
+  if (head != this->m_curr_tail.load(acquire)) {
+    return false;
+  }
+
+  const auto [tail, enq_idx] = marked_ptr_t(this->m_tail.load(relaxed)).decompose();
+  return head == tail && (deq_idx >= this->max_node_size(head) || enq_idx <= deq_idx);
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::await_slot(queue::node_t* head, std::size_t idx) {
+  if constexpr (wait_t::enabled) {
+    const auto& slot = head->slots()[idx];
+    const auto written = [&slot] {
+      return (slot.load(relaxed) & node_t::slot_flags_t::ELEM_MASK) != 0;
+    };
+
+    if (written()) [[likely]] {
+      return;
+    }
+
+    // unless the enqueue index has passed the slot (or the tail has moved on to another node), its
+    // producer has not even arrived yet, so the queue is (almost) empty and waiting is futile
+    const auto [tail, enq_idx] = marked_ptr_t(this->m_tail.load(relaxed)).decompose();
+    if (tail == head && enq_idx <= idx) {
+      return;
+    }
+
+    wait_t::wait(written);
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+bool queue<T, NodeSize, Policies...>::is_sentinel(const queue::node_t* node) const noexcept {
+  if constexpr (GROWING) {
+    return node == reinterpret_cast<const node_t*>(this->m_growth.sentinel);
+  } else {
+    return false;
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+std::size_t
+queue<T, NodeSize, Policies...>::min_node_size(const queue::node_t* node) const noexcept {
+  if constexpr (GROWING) {
+    return this->is_sentinel(node) ? 0 : MIN_NODE_SIZE;
+  } else {
+    return NODE_SIZE;
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+std::size_t
+queue<T, NodeSize, Policies...>::max_node_size(const queue::node_t* node) const noexcept {
+  return this->is_sentinel(node) ? 0 : NODE_SIZE;
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::mark_idle() noexcept {
+  if constexpr (growth_t::shrink) {
+    // the flag is only written if it is not already set, so empty queues cause no write traffic
+    if (!this->m_growth.idle.load(relaxed)) {
+      this->m_growth.idle.store(true, relaxed);
+    }
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::clear_idle() noexcept {
+  if constexpr (growth_t::shrink) {
+    if (this->m_growth.idle.load(relaxed)) {
+      this->m_growth.idle.store(false, relaxed);
+    }
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+std::size_t queue<T, NodeSize, Policies...>::next_node_size(const queue::node_t* tail) noexcept {
+  if constexpr (growth_t::shrink) {
+    if (this->m_growth.idle.load(relaxed)) {
+      return MIN_NODE_SIZE;
+    }
+  }
+
+  if constexpr (GROWING) {
+    // each node is only appended once its predecessor is full, so sizes double under load
+    return std::clamp<std::size_t>(2 * tail->size(), MIN_NODE_SIZE, NODE_SIZE);
+  } else {
+    return NODE_SIZE;
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+std::pmr::memory_resource* queue<T, NodeSize, Policies...>::node_resource() const noexcept {
+  if (const auto pool = this->m_pool.load(acquire); pool != nullptr) {
+    return pool;
+  }
+
+  return this->m_resource;
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::create_pool() {
+  if (this->m_pool_capacity == 0 || this->m_pool.load(relaxed) != nullptr) [[likely]] {
+    return;
+  }
+
+  // blocks allocated before the pool was created are from its upstream resource, so these can be
+  // retained by the pool as well
+  auto pool = std::make_unique<node_pool>(this->m_pool_capacity, this->m_resource);
+  if constexpr (GROWING) {
+    // nodes of the max. size are allocated under load, so these are pooled for re-use
+    pool->set_layout(node_t::bytes(NODE_SIZE), NODE_ALIGN);
+  }
+
+  node_pool* expected = nullptr;
+  if (this->m_pool.compare_exchange_strong(expected, pool.get(), release, relaxed)) {
+    pool.release();
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void* queue<T, NodeSize, Policies...>::allocate_node_memory(std::size_t bytes) {
+  if constexpr (RELATIVE) {
+    // the arena is in the same segment as the queue, so it is reachable from every process
+    return this->m_arena.arena->allocate(bytes, NODE_ALIGN);
+  } else {
+    return this->node_resource()->allocate(bytes, NODE_ALIGN);
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::deallocate_node_memory(
+    void* memory,
+    std::size_t bytes
+) noexcept {
+  if constexpr (RELATIVE) {
+    this->m_arena.arena->deallocate(memory, bytes);
+  } else {
+    this->node_resource()->deallocate(memory, bytes, NODE_ALIGN);
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+template <typename... Args>
+typename queue<T, NodeSize, Policies...>::node_t*
+queue<T, NodeSize, Policies...>::alloc_node(std::size_t size, Args&&... args) {
+  const auto memory = this->allocate_node_memory(node_t::bytes(size));
+  if (!marked_ptr_t::is_valid(static_cast<node_t*>(memory))) [[unlikely]] {
+    // the node's address overlaps with the tag bits (high-bit tagging only)
+    this->deallocate_node_memory(memory, node_t::bytes(size));
+    throw std::bad_alloc();
+  }
+
+  this->m_stats.increment(queue_event::NODE_ALLOC);
+  LOO_TRACE(node_alloc, memory, size);
+  return new(memory) node_t(this, size, std::forward<Args>(args)...);
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::dealloc_node(queue::node_t* node) noexcept {
+  const auto bytes = node_t::bytes(node->size());
+  node->~node_t();
+  this->deallocate_node_memory(node, bytes);
+  this->m_stats.increment(queue_event::NODE_FREE);
+  LOO_TRACE(node_free, node, bytes);
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::reclaim_node(queue::node_t* node) noexcept {
+  // the initial node has no slots and is embedded in the queue, so it is never de-allocated
+  if (this->is_sentinel(node)) {
+    return;
+  }
+
+  if (this->is_bounded()) {
+    this->m_slot_count.fetch_sub(node->size(), relaxed);
+  }
+
+  this->dealloc_node(node);
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+typename queue<T, NodeSize, Policies...>::node_t*
+queue<T, NodeSize, Policies...>::create_node(queue::slot_t elem, const queue::node_t* tail) {
+  if constexpr (spare_t::enabled) {
+    if (auto node = this->m_spare.node.exchange(nullptr, acquire); node != nullptr) {
+      // the spare node is already initialized, so only the first slot has to be set
+      node->slots()[0].store(elem, relaxed);
+      return node;
+    }
+  }
+
+  this->create_pool();
+  return this->alloc_node(this->next_node_size(tail), elem);
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::discard_node(queue::node_t* node) noexcept {
+  if constexpr (spare_t::enabled) {
+    // the node has never been appended, so it can be re-used once its first slot is reset
+    node->slots()[0].store(node_t::slot_flags_t::UNINIT, relaxed);
+    node_t* expected = nullptr;
+    if (this->m_spare.node.compare_exchange_strong(expected, node, release, relaxed)) {
+      return;
+    }
+  }
+
+  this->dealloc_node(node);
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+void queue<T, NodeSize, Policies...>::prepare_spare_node() {
+  if constexpr (spare_t::enabled) {
+    // a node discarded by a producer losing the race for appending may still be retained
+    if (this->m_spare.node.load(relaxed) != nullptr) {
+      return;
+    }
+
+    this->create_pool();
+    auto node = this->alloc_node(NODE_SIZE);
+    node_t* expected = nullptr;
+    if (!this->m_spare.node.compare_exchange_strong(expected, node, release, relaxed)) {
+      this->dealloc_node(node);
+    }
+  }
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+detail::advance_head_res_t queue<T, NodeSize, Policies...>::try_advance_head(
   queue::marked_ptr_t  curr,
   queue::node_t* const head,
   std::size_t idx
@@ -168,7 +947,7 @@ detail::advance_head_res_t queue<T>::try_advance_head(
   // the first slow-path operation initiates the reclamation checks for the current node, which
   // ensures the procedure is most likely to succeed on the first attempt since all previous enqueue
   // and dequeue operations must have already been initiated (but not necessarily completed)
-  if (idx == NODE_SIZE) {
+  if (idx == head->size()) {
     head->try_reclaim(0);
   }
 
@@ -176,6 +955,9 @@ detail::advance_head_res_t queue<T>::try_advance_head(
     // if the tail has not yet been updated, the head must not be advanced ahead of it, even if
     // there already is a new node installed through the next pointer
     head->increment_dequeue_count();
+    this->m_stats.increment(queue_event::EMPTY_HEAD_ADVANCE);
+    LOO_TRACE(head_empty, head, idx);
+    this->mark_idle();
     return detail::advance_head_res_t::QUEUE_EMPTY;
   }
 
@@ -187,7 +969,7 @@ detail::advance_head_res_t queue<T>::try_advance_head(
   if (bounded_cas_loop(this->m_head, curr, marked_ptr_t(next, 0), head, release)) {
     // the current thread succeeded in exchanging the node and is hence the operation that observed
     // the final index value (count) of a all dequeue operations accessing this node
-    head->increment_dequeue_count(curr.decompose_tag() - NODE_SIZE);
+    head->increment_dequeue_count(curr.decompose_tag() - head->size());
   } else {
     // some other node succeeded in exchanging the head and the operation is also complete
     head->increment_dequeue_count();
@@ -196,10 +978,11 @@ detail::advance_head_res_t queue<T>::try_advance_head(
   return detail::advance_head_res_t::ADVANCED;
 }
 
-template <typename T>
-detail::advance_tail_res_t queue<T>::try_advance_tail(
-    queue::pointer elem,
-    queue::node_t* const tail
+template <typename T, std::size_t NodeSize, typename... Policies>
+detail::advance_tail_res_t queue<T, NodeSize, Policies...>::try_advance_tail(
+    queue::slot_t elem,
+    queue::node_t* const tail,
+    bool bounded
 ) {
   std::uint64_t final_count = 0;
   // re-load the tail pointer to check if it has already been advanced
@@ -215,15 +998,34 @@ detail::advance_tail_res_t queue<T>::try_advance_tail(
   // load the current tail's next pointer to check if another thread has already appended a new
   // node to the queue but has not yet updated the tail pointer
   auto next = tail->next.load(relaxed);
+  if (next == nullptr && bounded && this->m_slot_count.load(acquire) >= this->m_max_slots) {
+    // the node limit has been reached, but the count may have been raised by a concurrent append
+    // after the tail's next pointer was loaded, in which case this thread has to help advancing the
+    // tail instead of failing (see PROOF.md)
+    next = tail->next.load(acquire);
+    if (next == nullptr) {
+      tail->increment_enqueue_count();
+      return detail::advance_tail_res_t::QUEUE_FULL;
+    }
+  }
+
   if (next == nullptr) {
-    // there is no new node yet, allocate a new one and attempt to append it
-    auto node = new(std::align_val_t{ NODE_ALIGN }) node_t(elem);
+    // there is no new node yet, take the spare node or allocate a new one and attempt to append it
+    auto node = this->create_node(elem, tail);
     auto advanced = detail::advance_tail_res_t::ADVANCED;
     const auto res = tail->next.compare_exchange_strong(next, node, release, relaxed);
     if (res) {
+      if (this->is_bounded()) {
+        // the count must be raised only AFTER appending the node (see above)
+        this->m_slot_count.fetch_add(node->size(), release);
+      }
+
+      this->clear_idle();
+      LOO_TRACE(node_append, tail, node, curr.decompose_tag());
+
       // the CAS succeeded in appending the node after the tail, now the tail has to be updated
       if (bounded_cas_loop(this->m_tail, curr, marked_ptr_t(node, 1), tail, release)) {
-        final_count = curr.decompose_tag() - NODE_SIZE;
+        final_count = curr.decompose_tag() - tail->size();
       }
 
       // it doesn't matter, which thread succeeded in updating the tail, since all must attempt to
@@ -232,7 +1034,7 @@ detail::advance_tail_res_t queue<T>::try_advance_tail(
       advanced = detail::advance_tail_res_t::ADVANCED_AND_INSERTED;
     } else {
       if (bounded_cas_loop(this->m_tail, curr, marked_ptr_t(next, 1), tail, release)) {
-        final_count = curr.decompose_tag() - NODE_SIZE;
+        final_count = curr.decompose_tag() - tail->size();
       }
     }
 
@@ -243,9 +1045,11 @@ detail::advance_tail_res_t queue<T>::try_advance_tail(
     tail->increment_enqueue_count(final_count);
 
     if (!res) {
-      // the CAS failed so another thread must have succeeded in appending a node, delete the node
-      // allocated by this thread and try again
-      delete node;
+      // the CAS failed so another thread must have succeeded in appending a node, release the node
+      // allocated by this thread (returning it to the pool) and try again
+      this->m_stats.increment(queue_event::FAILED_APPEND);
+      LOO_TRACE(append_failed, tail, node, curr.decompose_tag());
+      this->discard_node(node);
     }
 
     return advanced;
@@ -253,7 +1057,7 @@ detail::advance_tail_res_t queue<T>::try_advance_tail(
     // there is already a new node after the current tail, so this thread has to help updating the
     // queue's tail pointer and retry once the tail has been advanced
     if (bounded_cas_loop(this->m_tail, curr, marked_ptr_t(next, 1), tail, release)) {
-      final_count = curr.decompose_tag() - NODE_SIZE;
+      final_count = curr.decompose_tag() - tail->size();
     }
 
     // update the cached tail pointer
@@ -265,6 +1069,68 @@ detail::advance_tail_res_t queue<T>::try_advance_tail(
     return detail::advance_tail_res_t::ADVANCED;
   }
 }
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+bool queue<T, NodeSize, Policies...>::advance_head_single_consumer(queue::node_t* const head) {
+  if (head == marked_ptr_t{ this->m_tail.load(acquire) }.decompose_ptr()) {
+    this->m_stats.increment(queue_event::EMPTY_HEAD_ADVANCE);
+    LOO_TRACE(head_empty, head, head->size());
+    return false;
+  }
+
+  // the next pointer must have been set BEFORE updating the tail, there is no other dequeue
+  // operation, so the head is updated without a CAS and no slow-path dequeue ops are counted
+  const auto next = head->next.load(acquire);
+  this->m_head.store(marked_ptr_t(next, 0).to_uintptr(), relaxed);
+
+  if constexpr (SINGLE_PRODUCER) {
+    // all slots have been consumed by this thread and the single producer has already moved on to
+    // the successor node before publishing it, so the node can be reclaimed right away
+    LOO_TRACE(node_reclaim, head, node_t::reclaim_flags_t::DEQ);
+    this->reclaim_node(head);
+  } else {
+    // the reclamation checks are initiated exactly once, since the head is advanced only once
+    head->try_reclaim(0);
+    head->finish_dequeues();
+  }
+
+  return true;
+}
+
+template <typename T, std::size_t NodeSize, typename... Policies>
+bool queue<T, NodeSize, Policies...>::append_node_single_producer(
+    queue::slot_t elem,
+    queue::node_t* const tail,
+    bool bounded
+) {
+  // the count is only ever raised by this thread, so no concurrent append must be considered
+  if (bounded && this->m_slot_count.load(acquire) >= this->m_max_slots) {
+    return false;
+  }
+
+  // there is no other enqueue operation, so neither appending the node nor updating the tail
+  // requires a CAS and the tail index is never incremented beyond the node size
+  auto node = this->create_node(elem, tail);
+  tail->next.store(node, release);
+  if (this->is_bounded()) {
+    this->m_slot_count.fetch_add(node->size(), release);
+  }
+
+  this->clear_idle();
+  LOO_TRACE(node_append, tail, node, tail->size());
+
+  this->m_tail.store(marked_ptr_t(node, 1).to_uintptr(), release);
+  auto expected = tail;
+  this->m_curr_tail.compare_exchange_strong(expected, node, release, relaxed);
+
+  if constexpr (!SINGLE_CONSUMER) {
+    // the node can no longer be observed by any enqueue operation (with a single consumer, it is
+    // reclaimed directly, see `advance_head_single_consumer`)
+    tail->finish_enqueues();
+  }
+
+  return true;
+}
 }
 
 #endif /* LOO_QUEUE_HPP */
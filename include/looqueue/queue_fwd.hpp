@@ -2,60 +2,438 @@
 #define LOO_QUEUE_FWD_HPP
 
 #include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <span>
 
 #include "align.hpp"
-#include "detail/marked_ptr.hpp"
+#include "node_pool.hpp"
+#include "policy.hpp"
+#include "stats.hpp"
+#include "detail/event_count.hpp"
+#include "detail/relative_ptr.hpp"
+#include "detail/slot_codec.hpp"
 
 namespace loo {
 namespace detail {
 /** result type for private `try_advance_head` method */
 enum class advance_head_res_t { QUEUE_EMPTY, ADVANCED };
 /** result type for private `try_advance_tail` method */
-enum class advance_tail_res_t { ADVANCED, ADVANCED_AND_INSERTED };
+enum class advance_tail_res_t { ADVANCED, ADVANCED_AND_INSERTED, QUEUE_FULL };
+
+/** the slot for a prepared spare node (empty unless the `spare_node` policy is enabled) */
+template <typename AtomicPtr, bool Enabled>
+struct spare_slot_t {};
+
+template <typename AtomicPtr>
+struct spare_slot_t<AtomicPtr, true> {
+  alignas(CACHE_LINE_ALIGN) AtomicPtr node{ nullptr };
+};
+
+/** the waiting consumers (empty unless the `blocking` policy is enabled) */
+template <typename Waiter, std::size_t Align, bool Enabled>
+struct waiters_t {};
+
+template <typename Waiter, std::size_t Align>
+struct waiters_t<Waiter, Align, true> {
+  /** the event count for parking consumers blocked in `wait_dequeue` (read-mostly) */
+  alignas(Align) event_count parked{};
+  /** the stack of coroutines suspended in `async_dequeue` (read-mostly) */
+  std::atomic<Waiter*> async{ nullptr };
+};
+
+/** the arena from which all nodes are allocated (empty unless nodes are addressed relatively) */
+template <typename Arena, bool Enabled>
+struct node_arena_t {};
+
+template <typename Arena>
+struct node_arena_t<Arena, true> {
+  relative_ptr_t<Arena> arena{ nullptr };
+};
+
+/** the max. size of each node's header, which precedes its slots */
+inline constexpr std::size_t NODE_HEADER_SIZE = 32;
+
+/** the state for growing (and shrinking) node sizes (empty unless the policy is enabled) */
+template <std::size_t Align, bool Enabled>
+struct growth_state_t {};
+
+template <std::size_t Align>
+struct growth_state_t<Align, true> {
+  /** the storage of the initial node w/o any slots, which is never de-allocated */
+  alignas(Align) unsigned char sentinel[NODE_HEADER_SIZE];
+  /** set once the queue is found empty, so the next appended node is small again */
+  std::atomic_bool idle{ false };
+};
 }
 
-template <typename T>
+/** an executor, on which coroutines suspended in `queue::async_dequeue` are resumed */
+template <typename E>
+concept coroutine_executor = requires(E& executor, std::coroutine_handle<> handle) {
+  executor.execute(handle);
+};
+
+/** the default number of slots in each node of a `loo::queue` */
+inline constexpr std::size_t DEFAULT_NODE_SIZE = 1024;
+
+/** construction options for `loo::queue` */
+struct queue_options {
+  /**
+   * the max. number of reclaimed nodes retained by the queue's own pool for re-use, which is only
+   * created once the queue allocates its second node (`queue::DEFAULT_POOL_CAPACITY` if unset)
+   */
+  std::optional<std::size_t> pool_capacity{};
+  /**
+   * the resource from which all nodes are allocated instead of the queue's own pool, e.g., a
+   * `loo::node_pool` shared by multiple queues
+   */
+  std::pmr::memory_resource* resource = nullptr;
+  /**
+   * the (approximate) max. number of elements, which is enforced by `try_enqueue` at node
+   * granularity, 0 means unbounded (with growing nodes, the capacity may be exceeded by up to one
+   * node)
+   */
+  std::size_t capacity = 0;
+};
+
+/**
+ * A lock-free unbounded MPMC FIFO queue for non-null `T*` pointers or, if `T` is
+ * `detail::by_value<V>` (see `loo::value_queue`), for values of type `V`.
+ *
+ * Each node stores `NodeSize` elements, larger nodes make the slow path less frequent, smaller
+ * nodes reduce the memory footprint, but also the max. number of threads (see PROOF.md).
+ * `Policies` may contain at most one tagging policy (`low_bit_tagging` by default, see policy.hpp),
+ * at most one stats policy (`no_stats` by default, see stats.hpp), at most one producer and
+ * consumer role policy each (`multi_producer`/`multi_consumer` by default, see policy.hpp) and
+ * at most one spare node policy (`no_spare_node` by default, see policy.hpp), at most one wait
+ * policy (`no_wait` by default, see policy.hpp), at most one deleter policy (`no_deleter` by
+ * default, see policy.hpp), at most one padding policy (`cache_line_padding` by default, see
+ * policy.hpp), at most one node growth policy (`fixed_nodes` by default, see policy.hpp), at
+ * most one blocking policy (`no_blocking` by default, see policy.hpp) and at most one addressing
+ * policy (`absolute_addressing` by default, see policy.hpp).
+ */
+template <typename T, std::size_t NodeSize = DEFAULT_NODE_SIZE, typename... Policies>
 class queue {
-  static_assert(sizeof(T*) == 8, "loo::queue is only valid for 64-bit architectures");
-  static_assert(alignof(T) >= 4, "all T pointers must be at least 4-byte aligned");
-  /** the number of slots for storing individual elements in each node */
-  static constexpr auto NODE_SIZE = std::size_t{ 1024 };
-  static constexpr auto TAG_BITS  = std::size_t{ 11 };
+  static_assert(std::has_single_bit(NodeSize), "NodeSize must be a power of 2");
+  static_assert(NodeSize >= 4, "NodeSize must be at least 4");
+  static_assert(
+      detail::count_policies<detail::tagging_policy_tag, Policies...> <= 1,
+      "at most one tagging policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::stats_policy_tag, Policies...> <= 1,
+      "at most one stats policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::producer_policy_tag, Policies...> <= 1,
+      "at most one producer policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::consumer_policy_tag, Policies...> <= 1,
+      "at most one consumer policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::spare_policy_tag, Policies...> <= 1,
+      "at most one spare node policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::wait_policy_tag, Policies...> <= 1,
+      "at most one wait policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::deleter_policy_tag, Policies...> <= 1,
+      "at most one deleter policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::padding_policy_tag, Policies...> <= 1,
+      "at most one padding policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::growth_policy_tag, Policies...> <= 1,
+      "at most one node growth policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::blocking_policy_tag, Policies...> <= 1,
+      "at most one blocking policy must be given"
+  );
+  static_assert(
+      detail::count_policies<detail::addressing_policy_tag, Policies...> <= 1,
+      "at most one addressing policy must be given"
+  );
+
+  /** the encoding of elements into slots (see detail::slot_codec) */
+  using codec_t   = detail::slot_codec<T>;
+  /** the representation of (node pointer, index) pairs */
+  using tagging_t =
+      detail::select_policy_t<detail::tagging_policy_tag, low_bit_tagging, Policies...>;
+  /** the event counters (if enabled) */
+  using stats_t = detail::select_policy_t<detail::stats_policy_tag, no_stats, Policies...>;
+  /** the producer and consumer roles */
+  static constexpr bool SINGLE_PRODUCER =
+      detail::select_policy_t<detail::producer_policy_tag, multi_producer, Policies...>::single;
+  static constexpr bool SINGLE_CONSUMER =
+      detail::select_policy_t<detail::consumer_policy_tag, multi_consumer, Policies...>::single;
+  /** the preparation of spare nodes */
+  using spare_t = detail::select_policy_t<detail::spare_policy_tag, no_spare_node, Policies...>;
+  /** the waiting of consumers for slots, which have not been written yet */
+  using wait_t = detail::select_policy_t<detail::wait_policy_tag, no_wait, Policies...>;
+  /** the disposal of elements remaining in the queue upon its destruction */
+  using deleter_t = detail::select_policy_t<detail::deleter_policy_tag, no_deleter, Policies...>;
+  /** the alignment of the head and tail */
+  using padding_t =
+      detail::select_policy_t<detail::padding_policy_tag, cache_line_padding, Policies...>;
+  /** the sizes of appended nodes */
+  using growth_t = detail::select_policy_t<detail::growth_policy_tag, fixed_nodes, Policies...>;
+  static constexpr bool GROWING = growth_t::enabled;
+  /** the blocking (and suspending) of consumers until elements become available */
+  static constexpr bool BLOCKING =
+      detail::select_policy_t<detail::blocking_policy_tag, no_blocking, Policies...>::enabled;
+  /** the representation of all pointers stored in the queue and its nodes */
+  using addressing_t =
+      detail::select_policy_t<detail::addressing_policy_tag, absolute_addressing, Policies...>;
+  static constexpr bool RELATIVE = addressing_t::relative;
+  /** the arena from which all nodes are allocated (segment-relative addressing only) */
+  using arena_type = typename addressing_t::arena_type;
+  static_assert(!RELATIVE || !BLOCKING, "segment-relative queues can't block consumers");
+  /** the (max.) number of slots for storing individual elements in each node */
+  static constexpr auto NODE_SIZE = NodeSize;
+  /** the number of slots in the first node and in each node appended after going idle */
+  static constexpr std::size_t MIN_NODE_SIZE = growth_t::template min_size<NodeSize>;
+  static_assert(MIN_NODE_SIZE <= NODE_SIZE, "the min. node size must not exceed NodeSize");
+  /** the number of tag bits for storing the index of each (node pointer, index) pair */
+  static constexpr auto TAG_BITS  = tagging_t::template tag_bits<NodeSize>;
+  static_assert(TAG_BITS >= std::size_t(std::bit_width(NODE_SIZE)), "insufficient tag bits");
+  /** the final counts of slow-path operations (< 2^TAG_BITS - NODE_SIZE) must fit into 16 bits */
+  static_assert(TAG_BITS <= 16, "no more than 16 tag bits allowed");
   /**
    * Each node must be aligned to this value in order to be able to store the
-   * required number of tag bits in every node pointer.
+   * required number of tag bits in every node pointer (low-bit tagging only).
    */
-  static constexpr auto NODE_ALIGN = std::size_t{ 1 } << TAG_BITS;
+  static constexpr auto NODE_ALIGN = tagging_t::template node_align<NodeSize>;
+  /** the initial node is embedded in the queue, so it must not require excessive alignment */
+  static_assert(
+      !GROWING || NODE_ALIGN <= CACHE_LINE_ALIGN,
+      "growing nodes require high_bit_tagging (or nodes of at most cache line alignment)"
+  );
+  static_assert(!GROWING || !spare_t::enabled, "growing nodes can't be prepared as spare nodes");
   /** ordering constants */
   static constexpr auto relaxed = std::memory_order_relaxed;
   static constexpr auto acquire = std::memory_order_acquire;
   static constexpr auto release = std::memory_order_release;
   static constexpr auto acq_rel = std::memory_order_acq_rel;
+  static constexpr auto seq_cst = std::memory_order_seq_cst;
   /** see queue::node_t::slot_flags_t */
   using slot_t        = std::uintptr_t;
   using atomic_slot_t = std::atomic<slot_t>;
 
-  struct alignas(NODE_ALIGN) node_t;
-  using marked_ptr_t = typename detail::marked_ptr_t<node_t, TAG_BITS>;
+  struct node_t;
+  struct async_waiter_t;
+  using marked_ptr_t = typename tagging_t::template marked_ptr_t<node_t, TAG_BITS>;
+  /** the (possibly relative) atomic pointers and (node pointer, index) pairs */
+  template <typename P>
+  using atomic_ptr_t    = typename addressing_t::template atomic_ptr_t<P>;
+  using atomic_marked_t = typename addressing_t::template atomic_marked_t<marked_ptr_t>;
+
+  alignas(padding_t::align) atomic_marked_t      m_head{ 0 };
+  alignas(padding_t::align) atomic_marked_t      m_tail{ 0 };
+  alignas(padding_t::align) atomic_ptr_t<node_t> m_curr_tail;
+
+  /** the resource from which all nodes are allocated (the upstream of the queue's own pool) */
+  std::pmr::memory_resource* m_resource;
+  /**
+   * the queue's own pool for recycling nodes, which is created once a second node is allocated,
+   * so queues never exceeding their first node don't pay for it (null if disabled)
+   */
+  std::atomic<node_pool*>    m_pool{ nullptr };
+  /** the capacity of the queue's own pool (0 if disabled or an external resource is supplied) */
+  std::size_t                m_pool_capacity;
+  /** the max. number of slots in all nodes for `try_enqueue` (bounded queues only) */
+  std::size_t                m_max_slots;
 
-  alignas(CACHE_LINE_ALIGN) atomic_slot_t        m_head{ 0 };
-  alignas(CACHE_LINE_ALIGN) atomic_slot_t        m_tail{ 0 };
-  alignas(CACHE_LINE_ALIGN) std::atomic<node_t*> m_curr_tail;
+  /** the number of slots in all allocated nodes (bounded queues only, modified in slow path) */
+  alignas(padding_t::align) std::atomic_size_t m_slot_count{ 0 };
+  /** the initial node and the idle flag (empty unless nodes grow) */
+  [[no_unique_address]] detail::growth_state_t<NODE_ALIGN, GROWING> m_growth;
+  /** the blocked consumers and suspended coroutines (empty unless blocking is enabled) */
+  [[no_unique_address]] detail::waiters_t<async_waiter_t, padding_t::align, BLOCKING> m_waiters;
+  /** the event counters (empty if disabled) */
+  [[no_unique_address]] typename stats_t::counters_t m_stats;
+  /** the prepared spare node (empty if disabled) */
+  [[no_unique_address]] detail::spare_slot_t<atomic_ptr_t<node_t>, spare_t::enabled> m_spare;
+  /** the arena from which all nodes are allocated (empty unless addressing is segment-relative) */
+  [[no_unique_address]] detail::node_arena_t<arena_type, RELATIVE> m_arena;
 
 public:
-  using pointer = T*;
+  /** the type of enqueued elements (`T*` or `V` for value queues) */
+  using value_type  = typename codec_t::value_type;
+  /** the type of dequeued elements (`T*` or `std::optional<V>` for value queues) */
+  using result_type = typename codec_t::result_type;
   /** see PROOF.md for the reasoning behind these constants */
-  static constexpr std::size_t MAX_PRODUCER_THREADS = (1ull << TAG_BITS) - NODE_SIZE + 1;
-  static constexpr std::size_t MAX_CONSUMER_THREADS = ((1ull << TAG_BITS) - NODE_SIZE + 1) / 2;
+  static constexpr std::size_t MAX_PRODUCER_THREADS =
+      SINGLE_PRODUCER ? 1 : (1ull << TAG_BITS) - NODE_SIZE + 1;
+  static constexpr std::size_t MAX_CONSUMER_THREADS =
+      SINGLE_CONSUMER ? 1 : ((1ull << TAG_BITS) - NODE_SIZE + 1) / 2;
+  /** the thread limit for producers using `try_enqueue` on bounded queues (see PROOF.md) */
+  static constexpr std::size_t MAX_BOUNDED_PRODUCER_THREADS =
+      SINGLE_PRODUCER ? 1 : ((1ull << TAG_BITS) - NODE_SIZE + 1) / 2;
+  /** the index of the slot whose producer prepares the next spare node (NODE_SIZE if disabled) */
+  static constexpr std::size_t SPARE_WATERMARK = spare_t::template watermark<NodeSize>;
+  /** the number of dequeue attempts in `wait_dequeue` before a consumer is parked */
+  static constexpr std::size_t WAIT_SPIN_COUNT = 128;
+  /** the max. number of spins between two attempts in `poll_dequeue_for` */
+  static constexpr std::uint32_t POLL_MAX_SPINS = 1024;
+  /**
+   * the default number of reclaimed nodes retained by each queue's own pool for re-use, queues w/
+   * growing nodes are meant to stay small while idle, so they retain no nodes by default
+   */
+  static constexpr std::size_t DEFAULT_POOL_CAPACITY = GROWING ? 0 : 4;
 
-  /** constructor */
-  queue();
-  /** destructor */
+  /** constructor (default) */
+  queue() : queue(queue_options{}) {}
+  /** constructor w/ own node pool retaining at most `pool_capacity` reclaimed nodes */
+  explicit queue(std::size_t pool_capacity) :
+    queue(queue_options{ .pool_capacity = pool_capacity }) {}
+  /**
+   * constructor w/ external memory resource, from which all nodes are allocated, e.g., a
+   * `loo::node_pool` shared by multiple queues
+   */
+  explicit queue(std::pmr::memory_resource& resource) :
+    queue(queue_options{ .resource = &resource }) {}
+  /** constructor w/ options */
+  explicit queue(const queue_options& options) requires (!RELATIVE);
+  /**
+   * constructor w/ the arena, from which all nodes are allocated (segment-relative addressing
+   * only), the queue must be constructed in the arena's segment as well
+   */
+  template <typename Arena>
+  requires (RELATIVE && std::same_as<Arena, arena_type>)
+  explicit queue(Arena& arena) : m_resource{ nullptr }, m_pool_capacity{ 0 }, m_max_slots{ 0 } {
+    this->m_arena.arena = &arena;
+    this->init_head();
+  }
+  /** destructor (hands all remaining elements to the deleter policy's deleter, if enabled) */
   ~queue() noexcept;
-  /** enqueue an element to the queue's back */
-  void enqueue(pointer elem);
-  /** dequeue an element from the queue's front */
-  pointer dequeue();
+  /** enqueue an element to the queue's back (ignoring the capacity of bounded queues) */
+  void enqueue(value_type elem);
+  /**
+   * attempts to enqueue an element to the queue's back, fails only if the queue is bounded and
+   * no further node can be appended without exceeding its capacity
+   *
+   * the capacity is only checked once a node is full, so the fast path is unaffected
+   */
+  bool try_enqueue(value_type elem);
+  /**
+   * enqueue all elements in [first, last) to the queue's back in order, reserving as many
+   * consecutive slots as possible with a single atomic operation
+   */
+  template <std::forward_iterator It>
+  void enqueue_bulk(It first, It last);
+  /** enqueue all elements in `elems` to the queue's back in order */
+  void enqueue_bulk(std::span<const value_type> elems) {
+    this->enqueue_bulk(elems.begin(), elems.end());
+  }
+  /** dequeue an element from the queue's front (`nullptr` or empty if the queue is empty) */
+  result_type dequeue();
+  /**
+   * dequeue an element from the queue's front, unless the queue is found empty through plain
+   * loads (`nullptr` or empty), for polling (mostly) empty queues
+   *
+   * unlike `dequeue`, whose check acquires ownership of the head's cache line ahead of incrementing
+   * the dequeue index, polling an empty queue never writes to any shared cache line, so pollers
+   * neither contend with each other nor delay producers by invalidating the head
+   */
+  result_type try_dequeue();
+  /**
+   * dequeue an element from the queue's front, polling it through `try_dequeue` until an element
+   * becomes available or `timeout` has expired (without parking), in which case `nullptr` (or an
+   * empty value) is returned
+   *
+   * the spins between two attempts double after each unsuccessful one (up to POLL_MAX_SPINS), so
+   * idle pollers load the tail's cache line less frequently
+   */
+  template <typename Rep, typename Period>
+  result_type poll_dequeue_for(const std::chrono::duration<Rep, Period>& timeout);
+  /**
+   * dequeue up to `max` elements from the queue's front in order and write them to `out`,
+   * reserving as many consecutive slots as possible with a single atomic operation
+   *
+   * returns the number of dequeued elements, which is less than `max` only if the queue was
+   * (determined to be) empty
+   */
+  template <std::output_iterator<value_type> OutIt>
+  std::size_t dequeue_bulk(OutIt out, std::size_t max);
+  /** dequeue up to `out.size()` elements from the queue's front in order and write them to `out` */
+  std::size_t dequeue_bulk(std::span<value_type> out) {
+    return this->dequeue_bulk(out.begin(), out.size());
+  }
+  /**
+   * dequeue all elements from the queue's front in order and call `fn` with each of them, until
+   * the queue is (determined to be) empty, returns the number of dequeued elements
+   *
+   * all remaining slots of each node (up to the enqueue index, if it is the tail node) are claimed
+   * with a single atomic operation and visited in order, only advancing to the next node requires
+   * a regular dequeue operation, `fn` must not throw
+   */
+  template <std::invocable<value_type> Fn>
+  std::size_t consume_all(Fn&& fn) {
+    return this->consume_impl(fn, SIZE_MAX);
+  }
+  /** dequeue all elements from the queue's front in order and write them to `out` */
+  template <std::output_iterator<value_type> OutIt>
+  std::size_t drain(OutIt out) {
+    return this->dequeue_bulk(out, SIZE_MAX);
+  }
+  /**
+   * dequeue an element from the queue's front, blocking until one becomes available (`blocking`
+   * policy only)
+   *
+   * the consumer spins for a bounded number of attempts before it is parked, producers only have
+   * to issue wake-ups while consumers are actually parked
+   */
+  value_type wait_dequeue() requires BLOCKING;
+  /**
+   * dequeue an element from the queue's front, blocking until one becomes available or `timeout`
+   * has expired, in which case `nullptr` (or an empty value) is returned (`blocking` policy only)
+   */
+  template <typename Rep, typename Period>
+  result_type wait_dequeue_for(const std::chrono::duration<Rep, Period>& timeout)
+  requires BLOCKING {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    return this->wait_dequeue_impl(&deadline);
+  }
+
+  /** the awaitable returned by `async_dequeue` */
+  template <coroutine_executor Executor>
+  class dequeue_awaitable;
+
+  /**
+   * returns an awaitable for dequeuing an element from the queue's front, which completes
+   * immediately if an element is available and otherwise suspends the awaiting coroutine until
+   * a subsequent enqueue operation hands it an element, after which it is resumed on `executor`
+   *
+   * no thread ever blocks, the enqueuing thread dequeues elements on behalf of suspended
+   * coroutines (so producers count as consumers regarding MAX_CONSUMER_THREADS) and all suspended
+   * coroutines must have been resumed before the queue is destroyed (`blocking` policy only, not
+   * available w/ a single consumer, since enqueuing threads dequeue on behalf of suspended
+   * coroutines)
+   */
+  template <coroutine_executor Executor>
+  dequeue_awaitable<Executor> async_dequeue(Executor& executor)
+  requires (BLOCKING && !SINGLE_CONSUMER);
+
+  /**
+   * returns a snapshot of the queue's event counters, which are all zero unless a stats policy
+   * (e.g., `loo::sharded_stats`) is enabled
+   */
+  [[nodiscard]] queue_stats stats() const noexcept {
+    return this->m_stats.snapshot();
+  }
 
   /** deleted constructors & assignment operators */
   queue(const queue&)            = delete;
@@ -69,14 +447,112 @@ private:
    * or the loaded pointer value (failure case) no longer matches `old_node`
    */
   static bool bounded_cas_loop(
-      atomic_slot_t&    node,
+      atomic_marked_t&  node,
       marked_ptr_t&     expected,
       marked_ptr_t      desired,
       const node_t*     old_node,
       std::memory_order order
   );
 
+  /** allocates (or constructs) the initial node and lets both head and tail point at it */
+  void init_head();
+  /**
+   * encodes `elem` into its slot bits, pointer elements are stored as their distance from the queue
+   * w/ segment-relative addressing
+   */
+  [[nodiscard]] slot_t encode(const value_type& elem) const noexcept;
+  /** decodes the (masked) element bits of a slot */
+  [[nodiscard]] value_type decode(slot_t bits) const noexcept;
+
   bool is_empty() noexcept;
+  /** the read-only variant of `is_empty` (may also return false if the queue has become empty) */
+  [[nodiscard]] bool looks_empty() const noexcept;
+
+  [[nodiscard]] bool is_bounded() const noexcept {
+    return this->m_max_slots != 0;
+  }
+
+  /** a coroutine suspended in `async_dequeue` */
+  struct async_waiter_t {
+    async_waiter_t*         next = nullptr;
+    /** the element handed to the coroutine */
+    result_type             result{};
+    std::coroutine_handle<> handle{};
+    /** schedules the coroutine on its executor */
+    void (*schedule)(async_waiter_t*) = nullptr;
+  };
+
+  /**
+   * notifies threads blocked in `wait_dequeue` and coroutines suspended in `async_dequeue` (no-op
+   * unless blocking is enabled)
+   */
+  void notify_waiters(std::uint32_t count = 1);
+  /**
+   * registers a coroutine suspended in `async_dequeue` and re-checks the queue, once called,
+   * `waiter` may be resumed (and destroyed) at any time
+   */
+  void suspend_async_waiter(async_waiter_t* waiter);
+  /** hands available elements to suspended coroutines and schedules them for resumption */
+  void resume_async_waiters();
+
+  /** shared implementation of `wait_dequeue` and `wait_dequeue_for` (no timeout if null) */
+  result_type wait_dequeue_impl(const std::chrono::steady_clock::time_point* deadline);
+
+  /** shared implementation of `enqueue` and `try_enqueue` (`elem` is already encoded) */
+  bool enqueue_impl(slot_t elem, bool bounded);
+  /** implementation of `enqueue_impl` for the `single_producer` policy */
+  bool enqueue_single_producer(slot_t elem, bool bounded);
+  /** implementation of `dequeue` for the `single_consumer` policy */
+  result_type dequeue_single_consumer();
+  /** shared implementation of `dequeue_bulk` and `consume_all` (`fn` is called per element) */
+  template <typename Fn>
+  std::size_t consume_impl(Fn& fn, std::size_t max);
+  /**
+   * waits (according to the wait policy) for the slot at `idx` in `head`, which the calling
+   * consumer has reserved, to be written, if its producer has already reserved it as well
+   */
+  void await_slot(node_t* head, std::size_t idx);
+
+  /** returns true if `node` is the initial node embedded in the queue (growing nodes only) */
+  bool is_sentinel(const node_t* node) const noexcept;
+  /**
+   * return lower and upper bounds for the number of slots of `node` without accessing it, which is
+   * required unless the calling thread has reserved one of its slots (or is the only producer or
+   * consumer), since it may be reclaimed concurrently
+   */
+  std::size_t min_node_size(const node_t* node) const noexcept;
+  std::size_t max_node_size(const node_t* node) const noexcept;
+  /** marks the queue as idle, so the next appended node is small again (shrinking nodes only) */
+  void mark_idle() noexcept;
+  /** clears the idle mark once a node has been appended (shrinking nodes only) */
+  void clear_idle() noexcept;
+  /** returns the number of slots of the node appended after `tail` */
+  std::size_t next_node_size(const node_t* tail) noexcept;
+
+  /** returns the queue's own pool, once it has been created, or else its memory resource */
+  std::pmr::memory_resource* node_resource() const noexcept;
+  /** creates the queue's own pool, unless it is disabled or has already been created */
+  void create_pool();
+  /** allocates `bytes` bytes for a node from the queue's memory resource (or its arena) */
+  void* allocate_node_memory(std::size_t bytes);
+  /** de-allocates the memory of a node of `bytes` bytes (or returns it to the queue's arena) */
+  void deallocate_node_memory(void* memory, std::size_t bytes) noexcept;
+  /** allocates and constructs a new node w/ `size` slots from the queue's memory resource */
+  template <typename... Args>
+  node_t* alloc_node(std::size_t size, Args&&... args);
+  /** destroys and de-allocates (or recycles) `node` */
+  void dealloc_node(node_t* node) noexcept;
+  /** de-allocates a reclaimed node that was previously part of the queue */
+  void reclaim_node(node_t* node) noexcept;
+  /**
+   * returns a new node to be appended after `tail` w/ `elem` stored in its first slot, which may
+   * be the prepared spare node
+   */
+  node_t* create_node(slot_t elem, const node_t* tail);
+  /** retains a never appended node as spare node (if enabled & there is none) or de-allocates it */
+  void discard_node(node_t* node) noexcept;
+  /** prepares a spare node, unless there already is one (spare node policy only) */
+  void prepare_spare_node();
 
   /** Attempts to advance the head node to its successor, if there is one. */
   detail::advance_head_res_t try_advance_head(
@@ -87,10 +563,31 @@ private:
   /**
    * Attempts to advance the tail node to its successor if there is one or
    * attempts to append a new node with `elem` stored in the first slot
-   * otherwise.
+   * otherwise, unless `bounded` is set and the queue's capacity is reached.
    */
-  detail::advance_tail_res_t try_advance_tail(pointer elem, node_t* tail);
+  detail::advance_tail_res_t try_advance_tail(slot_t elem, node_t* tail, bool bounded);
+
+  /**
+   * Advances the head node to its successor, if there is one (`single_consumer` only), returns
+   * false if the queue is empty.
+   */
+  bool advance_head_single_consumer(node_t* head);
+  /**
+   * Appends a new node with `elem` stored in its first slot (`single_producer` only), unless
+   * `bounded` is set and the queue's capacity is reached, in which case false is returned.
+   */
+  bool append_node_single_producer(slot_t elem, node_t* tail, bool bounded);
 };
+
+/**
+ * A queue for values of type `V`, which are stored directly in the queue's slots, so no
+ * allocations are required for individual elements.
+ *
+ * `V` must be trivially copyable and at most 8 bytes large, 8 byte values must fit into 62 bits
+ * (see detail::slot_codec).
+ */
+template <typename V, std::size_t NodeSize = DEFAULT_NODE_SIZE, typename... Policies>
+using value_queue = queue<detail::by_value<V>, NodeSize, Policies...>;
 }
 
 #endif /* LOO_QUEUE_FWD_HPP */
@@ -0,0 +1,86 @@
+#ifndef LOO_QUEUE_SHM_QUEUE_HPP
+#define LOO_QUEUE_SHM_QUEUE_HPP
+
+#include <cstdint>
+#include <stdexcept>
+
+#include "looqueue/policy.hpp"
+#include "looqueue/queue.hpp"
+#include "looqueue/shm_segment.hpp"
+#include "looqueue/detail/relative_ptr.hpp"
+
+namespace loo {
+/**
+ * A lock-free unbounded MPMC FIFO queue, which lives entirely in a shared memory segment (see
+ * `loo::shm_segment`), so threads in different processes can exchange elements without any system
+ * calls.
+ *
+ * The queue must be constructed in the segment through its arena (`arena.construct<shm_queue<T>>
+ * (arena)`), all its nodes are allocated from the same arena and all elements must point into the
+ * segment as well (e.g., payloads allocated from the arena).
+ * Since each process maps the segment at its own address, the underlying `loo::queue` uses
+ * `segment_addressing`, which stores the head, tail and next pointers (and all elements) relative
+ * to their own address (or the queue's), so the same LOO protocol is shared with all other queues.
+ * Nodes are reclaimed by whichever thread (in whichever process) concludes the last operation on
+ * them and are returned to the arena.
+ *
+ * The thread limits apply to the sum of all threads in all processes accessing the queue, a process
+ * terminating during an operation may leave the queue in an inconsistent state.
+ */
+template <typename T, std::size_t NodeSize = 1024>
+class shm_queue {
+public:
+  /** the underlying queue, whose nodes are allocated from the arena */
+  using queue_type = queue<T, NodeSize, high_bit_tagging<>, segment_addressing<shm_arena>>;
+
+  /** the number of slots in each node */
+  static constexpr auto NODE_SIZE = NodeSize;
+  /** see PROOF.md for the reasoning behind these constants (counting threads in all processes) */
+  static constexpr std::size_t MAX_PRODUCER_THREADS = queue_type::MAX_PRODUCER_THREADS;
+  static constexpr std::size_t MAX_CONSUMER_THREADS = queue_type::MAX_CONSUMER_THREADS;
+
+  /** constructor (the queue itself must be allocated from `arena`) */
+  explicit shm_queue(shm_arena& arena) : m_arena{ &in_segment(arena, this) }, m_queue{ arena } {}
+
+  /** returns the arena, from which the queue's nodes are allocated */
+  [[nodiscard]] shm_arena& arena() const noexcept {
+    return *this->m_arena;
+  }
+
+  /** enqueue an element, which must point into the queue's segment, to the queue's back */
+  void enqueue(T* elem) {
+    // the element is stored as its distance from the queue, which must not be 0
+    if (elem == nullptr || !this->arena().contains(elem) || elem == (void*) &this->m_queue) {
+      throw std::invalid_argument("enqueue element must point into the queue's segment");
+    }
+
+    this->m_queue.enqueue(elem);
+  }
+
+  /** dequeue an element from the queue's front (`nullptr` if the queue is empty) */
+  T* dequeue() {
+    return this->m_queue.dequeue();
+  }
+
+  /** deleted constructors & assignment operators */
+  shm_queue(const shm_queue&)            = delete;
+  shm_queue(shm_queue&&)                 = delete;
+  shm_queue& operator=(const shm_queue&) = delete;
+  shm_queue& operator=(shm_queue&&)      = delete;
+
+private:
+  /** returns `arena`, if it contains `queue` */
+  static shm_arena& in_segment(shm_arena& arena, const shm_queue* queue) {
+    if (!arena.contains(queue)) {
+      throw std::invalid_argument("shm_queue must be allocated in its arena's segment");
+    }
+
+    return arena;
+  }
+
+  detail::relative_ptr_t<shm_arena> m_arena;
+  queue_type                        m_queue;
+};
+}
+
+#endif /* LOO_QUEUE_SHM_QUEUE_HPP */
@@ -0,0 +1,384 @@
+#ifndef LOO_QUEUE_SHM_SEGMENT_HPP
+#define LOO_QUEUE_SHM_SEGMENT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "looqueue/align.hpp"
+
+namespace loo {
+/**
+ * A lock-free allocator, which is placed at the start of a shared memory segment and carves
+ * blocks (e.g., queue nodes and payloads) out of the remainder of the segment.
+ *
+ * All state lives in the segment and all blocks are identified by their offsets from the arena
+ * (i.e., the segment's base), so processes mapping the segment at different addresses may allocate
+ * and de-allocate blocks concurrently.
+ * Blocks are cache line aligned and their sizes are rounded up to multiples of the cache line size,
+ * de-allocated blocks are retained in one lock-free free list per size for re-use.
+ * The segment persists beyond each process, so a leaked block would never be recovered, hence
+ * blocks of at most `SIZE_CLASSES` distinct sizes can be allocated, requests for any further size
+ * are rejected with `std::bad_alloc`.
+ */
+class shm_arena final {
+public:
+  /** the max. number of distinct block sizes, whose de-allocated blocks are retained for re-use */
+  static constexpr std::size_t SIZE_CLASSES = 16;
+  /** the number of bits for storing the offsets of blocks (the rest is used for ABA tags) */
+  static constexpr std::size_t OFFSET_BITS = 40;
+  /** the max. size of a segment, so each free list's head fits into a single (tagged) word */
+  static constexpr std::size_t MAX_SEGMENT_SIZE = std::size_t{ 1 } << OFFSET_BITS;
+
+  /** constructs the arena at the start of the (zeroed) segment of `size` bytes at `base` */
+  static shm_arena* create(void* base, std::size_t size) {
+    if (size > MAX_SEGMENT_SIZE || size < first_offset()) {
+      throw std::bad_alloc();
+    }
+
+    return new(base) shm_arena(size);
+  }
+
+  /** returns the arena at the start of the segment at `base`, which must have been created */
+  static shm_arena* attach(void* base) {
+    const auto arena = std::launder(static_cast<shm_arena*>(base));
+    if (arena->m_magic != MAGIC) {
+      throw std::system_error(std::make_error_code(std::errc::invalid_argument), "no loo arena");
+    }
+
+    return arena;
+  }
+
+  /** returns the size of the segment */
+  [[nodiscard]] std::size_t size() const noexcept {
+    return this->m_size;
+  }
+
+  /** returns the number of bytes in currently allocated blocks */
+  [[nodiscard]] std::size_t allocated_bytes() const noexcept {
+    return this->m_allocated.load(relaxed);
+  }
+
+  /** returns the offset of `ptr`, which must point into the segment, from the segment's base */
+  [[nodiscard]] std::uint64_t offset_of(const void* ptr) const noexcept {
+    return std::uint64_t(static_cast<const char*>(ptr) - reinterpret_cast<const char*>(this));
+  }
+
+  /** returns true if `ptr` points into an allocated part of the segment */
+  [[nodiscard]] bool contains(const void* ptr) const noexcept {
+    const auto addr = static_cast<const char*>(ptr);
+    const auto base = reinterpret_cast<const char*>(this);
+    return addr >= base + first_offset() && addr < base + this->m_size;
+  }
+
+  /** returns the address of the given offset in the calling process' mapping of the segment */
+  template <typename T>
+  [[nodiscard]] T* at(std::uint64_t offset) const noexcept {
+    return reinterpret_cast<T*>(reinterpret_cast<std::uintptr_t>(this) + offset);
+  }
+
+  /**
+   * allocates a block of (at least) `bytes` bytes, throws `std::bad_alloc` if none is left or if
+   * blocks of `SIZE_CLASSES` other sizes have already been allocated
+   */
+  void* allocate(std::size_t bytes, std::size_t alignment = CACHE_LINE_ALIGN) {
+    if (alignment > CACHE_LINE_ALIGN) {
+      throw std::bad_alloc();
+    }
+
+    // the free list is claimed before the first block of its size is handed out, so every block
+    // can be retained once de-allocated
+    bytes = round_up(bytes);
+    const auto list = this->find_free_list(bytes, true);
+    if (list == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    auto block = this->try_pop(*list);
+    if (block == nullptr) {
+      auto used = this->m_used.load(relaxed);
+      do {
+        if (used + bytes > this->m_size) {
+          throw std::bad_alloc();
+        }
+      } while (!this->m_used.compare_exchange_weak(used, used + bytes, relaxed, relaxed));
+      block = this->at<void>(used);
+    }
+
+    this->m_allocated.fetch_add(bytes, relaxed);
+    return block;
+  }
+
+  /** de-allocates a block of `bytes` bytes, which was allocated from this arena */
+  void deallocate(void* block, std::size_t bytes) noexcept {
+    bytes = round_up(bytes);
+    this->m_allocated.fetch_sub(bytes, relaxed);
+    // the block's free list was claimed when it was allocated
+    this->push(*this->find_free_list(bytes, false), block);
+  }
+
+  /** allocates and constructs a `T` in the segment, forwarding `args` to its constructor */
+  template <typename T, typename... Args>
+  T* construct(Args&&... args) {
+    static_assert(alignof(T) <= CACHE_LINE_ALIGN, "T must not require more than cache alignment");
+    const auto block = this->allocate(sizeof(T), alignof(T));
+    try {
+      return new(block) T(std::forward<Args>(args)...);
+    } catch (...) {
+      this->deallocate(block, sizeof(T));
+      throw;
+    }
+  }
+
+  /** destroys and de-allocates a `T` previously constructed in the segment */
+  template <typename T>
+  void destroy(T* obj) noexcept {
+    obj->~T();
+    this->deallocate(obj, sizeof(T));
+  }
+
+  /** publishes `root` (e.g., a queue), through which other processes find the segment's objects */
+  void set_root(const void* root) noexcept {
+    this->m_root.store(root == nullptr ? 0 : this->offset_of(root), std::memory_order_release);
+  }
+
+  /** returns the published root object (or `nullptr`) */
+  template <typename T>
+  [[nodiscard]] T* root() const noexcept {
+    const auto offset = this->m_root.load(std::memory_order_acquire);
+    return offset == 0 ? nullptr : this->at<T>(offset);
+  }
+
+  /** deleted constructors & assignment operators */
+  shm_arena(const shm_arena&)            = delete;
+  shm_arena(shm_arena&&)                 = delete;
+  shm_arena& operator=(const shm_arena&) = delete;
+  shm_arena& operator=(shm_arena&&)      = delete;
+
+private:
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+  static constexpr auto acq_rel = std::memory_order_acq_rel;
+
+  static constexpr std::uint64_t MAGIC = 0x6c6f6f2d73686d31; // "loo-shm1"
+  /** the low bits of each free list head store the offset, the high bits an ABA counter */
+  static constexpr std::uint64_t OFFSET_MASK = (std::uint64_t{ 1 } << OFFSET_BITS) - 1;
+  static constexpr std::uint64_t TAG_INCREMENT = std::uint64_t{ 1 } << OFFSET_BITS;
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "atomics must be lock-free");
+
+  /** a free list of blocks of a single size, linked through the first word of each block */
+  struct free_list_t {
+    /** the size of the list's blocks, 0 while the list is unused */
+    std::atomic<std::uint64_t> bytes{ 0 };
+    /** the (tagged) offset of the first block */
+    std::atomic<std::uint64_t> head{ 0 };
+  };
+
+  explicit shm_arena(std::size_t size) : m_size{ size } {}
+
+  static std::size_t round_up(std::size_t bytes) noexcept {
+    bytes = std::max<std::size_t>(bytes, 1);
+    return (bytes + CACHE_LINE_ALIGN - 1) / CACHE_LINE_ALIGN * CACHE_LINE_ALIGN;
+  }
+
+  /** the offset of the first block, which follows the arena */
+  static constexpr std::size_t first_offset() noexcept {
+    return (sizeof(shm_arena) + CACHE_LINE_ALIGN - 1) / CACHE_LINE_ALIGN * CACHE_LINE_ALIGN;
+  }
+
+  /** returns the free list for blocks of `bytes` bytes (claiming an unused one, if `claim`) */
+  free_list_t* find_free_list(std::size_t bytes, bool claim) noexcept {
+    for (auto& list : this->m_free_lists) {
+      auto expected = list.bytes.load(acquire);
+      if (expected == 0 && claim) {
+        if (list.bytes.compare_exchange_strong(expected, bytes, acq_rel, acquire)) {
+          return &list;
+        }
+      }
+
+      if (expected == bytes) {
+        return &list;
+      } else if (expected == 0) {
+        // lists are claimed in order, so no later list is in use either
+        return nullptr;
+      }
+    }
+
+    return nullptr;
+  }
+
+  /** returns the link to the successor stored in the first word of a free `block` */
+  static std::atomic_ref<std::uint64_t> link(void* block) noexcept {
+    return std::atomic_ref<std::uint64_t>{ *static_cast<std::uint64_t*>(block) };
+  }
+
+  void push(free_list_t& list, void* block) noexcept {
+    const auto offset = this->offset_of(block);
+    auto head = list.head.load(relaxed);
+    do {
+      link(block).store(head & OFFSET_MASK, relaxed);
+    } while (!list.head.compare_exchange_weak(
+        head, ((head & ~OFFSET_MASK) + TAG_INCREMENT) | offset, release, relaxed
+    ));
+  }
+
+  void* try_pop(free_list_t& list) noexcept {
+    auto head = list.head.load(acquire);
+    while ((head & OFFSET_MASK) != 0) {
+      const auto block = this->at<void>(head & OFFSET_MASK);
+      // the block may be popped (and written) concurrently, in which case the tag has changed
+      // and the CAS fails, the segment is never unmapped, so reading its link is always safe
+      const auto next = link(block).load(relaxed);
+      const auto desired = ((head & ~OFFSET_MASK) + TAG_INCREMENT) | next;
+      if (list.head.compare_exchange_weak(head, desired, acquire, acquire)) {
+        return block;
+      }
+    }
+
+    return nullptr;
+  }
+
+  const std::uint64_t        m_magic{ MAGIC };
+  const std::uint64_t        m_size;
+  /** the offset of the published root object (0 if there is none) */
+  std::atomic<std::uint64_t> m_root{ 0 };
+  /** the number of bytes in currently allocated blocks */
+  std::atomic<std::uint64_t> m_allocated{ 0 };
+  /** the offset of the first never allocated byte */
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::uint64_t> m_used{ first_offset() };
+  free_list_t                m_free_lists[SIZE_CLASSES]{};
+};
+
+/**
+ * A POSIX shared memory object (see `shm_open`) mapped into the calling process, whose contents
+ * are managed by a `loo::shm_arena` at its start.
+ *
+ * Each process maps the segment at its own address, so all objects in the segment (e.g.,
+ * `loo::shm_queue`) must refer to each other through offsets.
+ * The mapping is released once the segment is destroyed, the shared memory object itself persists
+ * until it has been unlinked (see `unlink`) and all processes have unmapped it.
+ */
+class shm_segment final {
+public:
+  /** creates the shared memory object `name` (which must not exist yet) w/ `size` bytes */
+  static shm_segment create(const std::string& name, std::size_t size) {
+    const auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+      throw_errno("shm_open");
+    }
+
+    // the object is unlinked upon any failure, so the name can be used again
+    try {
+      if (ftruncate(fd, off_t(size)) == -1) {
+        const auto err = errno;
+        close(fd);
+        errno = err;
+        throw_errno("ftruncate");
+      }
+
+      // the object is zero-filled, so only the arena has to be constructed
+      shm_segment segment{ map(fd, size), size };
+      shm_arena::create(segment.m_base, size);
+      return segment;
+    } catch (...) {
+      shm_unlink(name.c_str());
+      throw;
+    }
+  }
+
+  /** opens (and maps) the existing shared memory object `name` created through `create` */
+  static shm_segment open(const std::string& name) {
+    const auto fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd == -1) {
+      throw_errno("shm_open");
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) == -1) {
+      const auto err = errno;
+      close(fd);
+      errno = err;
+      throw_errno("fstat");
+    }
+
+    const auto size = std::size_t(st.st_size);
+    shm_segment segment{ map(fd, size), size };
+    shm_arena::attach(segment.m_base);
+    return segment;
+  }
+
+  /** removes the shared memory object `name`, existing mappings remain valid */
+  static void unlink(const std::string& name) noexcept {
+    shm_unlink(name.c_str());
+  }
+
+  /** constructor (move) */
+  shm_segment(shm_segment&& other) noexcept :
+    m_base{ std::exchange(other.m_base, nullptr) },
+    m_size{ std::exchange(other.m_size, 0) }
+  {}
+
+  /** destructor (unmaps the segment) */
+  ~shm_segment() noexcept {
+    if (this->m_base != nullptr) {
+      munmap(this->m_base, this->m_size);
+    }
+  }
+
+  /** returns the arena at the segment's start */
+  [[nodiscard]] shm_arena& arena() const noexcept {
+    return *std::launder(static_cast<shm_arena*>(this->m_base));
+  }
+
+  /** returns the address at which the segment is mapped into the calling process */
+  [[nodiscard]] void* base() const noexcept {
+    return this->m_base;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return this->m_size;
+  }
+
+  /** deleted constructors & assignment operators */
+  shm_segment(const shm_segment&)            = delete;
+  shm_segment& operator=(const shm_segment&) = delete;
+  shm_segment& operator=(shm_segment&&)      = delete;
+
+private:
+  shm_segment(void* base, std::size_t size) : m_base{ base }, m_size{ size } {}
+
+  [[noreturn]] static void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+  }
+
+  /** maps `size` bytes of the shared memory object `fd` and closes it */
+  static void* map(int fd, std::size_t size) {
+    const auto base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const auto err = errno;
+    close(fd);
+    if (base == MAP_FAILED) {
+      errno = err;
+      throw_errno("mmap");
+    }
+
+    return base;
+  }
+
+  void*       m_base;
+  std::size_t m_size;
+};
+}
+
+#endif /* LOO_QUEUE_SHM_SEGMENT_HPP */
@@ -0,0 +1,110 @@
+#ifndef LOO_QUEUE_STATS_HPP
+#define LOO_QUEUE_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "align.hpp"
+#include "policy.hpp"
+
+namespace loo {
+/** the events counted by a stats policy */
+enum class queue_event : std::size_t {
+  /** an enqueue operation found the tail node full */
+  ENQUEUE_SLOW_PATH,
+  /** a dequeue operation found the head node fully consumed */
+  DEQUEUE_SLOW_PATH,
+  /** a dequeue operation set the READER bit before the element was written */
+  ABANDONED_SLOT,
+  /** appending a node failed due to a concurrent append, so the node was discarded */
+  FAILED_APPEND,
+  /** advancing the head failed, because the tail had not been advanced yet */
+  EMPTY_HEAD_ADVANCE,
+  /** `try_reclaim` found a slot still in use and handed off to its final visitor (RESUME) */
+  RECLAIM_HANDOFF,
+  /** a node was allocated */
+  NODE_ALLOC,
+  /** a node was de-allocated (or returned to a pool) */
+  NODE_FREE,
+};
+
+/** the number of distinct `queue_event`s */
+inline constexpr std::size_t QUEUE_EVENT_COUNT = 8;
+
+/** a snapshot of the event counters of a queue (all zero unless a stats policy is enabled) */
+struct queue_stats {
+  std::uint64_t enqueue_slow_paths  = 0;
+  std::uint64_t dequeue_slow_paths  = 0;
+  std::uint64_t abandoned_slots     = 0;
+  std::uint64_t failed_appends      = 0;
+  std::uint64_t empty_head_advances = 0;
+  std::uint64_t reclaim_handoffs    = 0;
+  std::uint64_t nodes_allocated     = 0;
+  std::uint64_t nodes_freed         = 0;
+};
+
+namespace detail {
+/** returns a small, unique index for the calling thread (assigned in order of first use) */
+inline std::size_t thread_index() noexcept {
+  static std::atomic_size_t next{ 0 };
+  thread_local const auto idx = next.fetch_add(1, std::memory_order_relaxed);
+  return idx;
+}
+}
+
+/** disables all event counters (default), which has neither space nor run-time overhead */
+struct no_stats {
+  using policy_category = detail::stats_policy_tag;
+
+  class counters_t {
+  public:
+    void increment(queue_event, std::uint64_t = 1) noexcept {}
+    [[nodiscard]] queue_stats snapshot() const noexcept {
+      return {};
+    }
+  };
+};
+
+/**
+ * Enables event counters, which are sharded across `Shards` cache-line aligned blocks to which
+ * threads are assigned round-robin, so counting does not cause additional contention between up to
+ * `Shards` threads.
+ */
+template <std::size_t Shards = 16>
+struct sharded_stats {
+  static_assert(Shards > 0, "at least one shard is required");
+  using policy_category = detail::stats_policy_tag;
+
+  class counters_t {
+  public:
+    void increment(queue_event event, std::uint64_t count = 1) noexcept {
+      auto& shard = this->m_shards[detail::thread_index() % Shards];
+      shard.counts[static_cast<std::size_t>(event)].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /** aggregates all shards, the result is not an atomic snapshot while the queue is in use */
+    [[nodiscard]] queue_stats snapshot() const noexcept {
+      std::array<std::uint64_t, QUEUE_EVENT_COUNT> sums{};
+      for (const auto& shard : this->m_shards) {
+        for (std::size_t event = 0; event < QUEUE_EVENT_COUNT; ++event) {
+          sums[event] += shard.counts[event].load(std::memory_order_relaxed);
+        }
+      }
+
+      return {
+        sums[0], sums[1], sums[2], sums[3], sums[4], sums[5], sums[6], sums[7]
+      };
+    }
+
+  private:
+    struct alignas(CACHE_LINE_ALIGN) shard_t {
+      std::array<std::atomic<std::uint64_t>, QUEUE_EVENT_COUNT> counts{};
+    };
+
+    std::array<shard_t, Shards> m_shards{};
+  };
+};
+}
+
+#endif /* LOO_QUEUE_STATS_HPP */
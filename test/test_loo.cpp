@@ -1,11 +1,1335 @@
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <exception>
 #include <iostream>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "looqueue/executor.hpp"
+#include "looqueue/huge_page_arena.hpp"
+#include "looqueue/multi_queue.hpp"
+#include "looqueue/numa_queue.hpp"
+#include "looqueue/priority_queue.hpp"
 #include "looqueue/queue.hpp"
+#include "looqueue/shm_queue.hpp"
+
+/**
+ * runs `threads` producers, which each call `enqueue(thread, op)` for `count` ops, alongside as many
+ * consumers, which each poll `dequeue()` until it has returned `count` values, and returns the sum
+ * of all dequeued values
+ */
+template <typename Enqueue, typename Dequeue>
+std::uint64_t transport(std::size_t threads, std::size_t count, Enqueue enqueue, Dequeue dequeue) {
+  std::atomic_uint64_t sum{ 0 };
+  std::vector<std::thread> workers{};
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    workers.emplace_back([&, thread] {
+      for (std::size_t op = 0; op < count; ++op) {
+        enqueue(thread, op);
+      }
+    });
+
+    workers.emplace_back([&] {
+      std::uint64_t thread_sum = 0;
+      for (std::size_t op = 0; op < count;) {
+        if (const auto res = dequeue(); res.has_value()) {
+          thread_sum += *res;
+          ++op;
+        }
+      }
+
+      sum.fetch_add(thread_sum);
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  return sum.load();
+}
+
+/** returns the value `res` points to (if any) */
+std::optional<std::uint64_t> value_of(const std::size_t* res) {
+  return res != nullptr ? std::optional<std::uint64_t>{ *res } : std::nullopt;
+}
+
+/** a resource counting the blocks it allocates from (and which are outstanding at) the heap */
+class counting_resource final : public std::pmr::memory_resource {
+public:
+  std::atomic_size_t allocated{ 0 };
+  std::atomic_size_t outstanding{ 0 };
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    const auto block = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    this->allocated.fetch_add(1);
+    this->outstanding.fetch_add(1);
+    return block;
+  }
+
+  void do_deallocate(void* block, std::size_t bytes, std::size_t alignment) override {
+    this->outstanding.fetch_sub(1);
+    std::pmr::new_delete_resource()->deallocate(block, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+/**
+ * checks that nodes reclaimed by (one or two) queues are re-used from a shared node pool, which
+ * never retains more than its capacity
+ */
+bool test_node_pool() {
+  using queue_t = loo::queue<std::size_t, 64, loo::sharded_stats<>>;
+  const std::size_t capacity = 8;
+  std::size_t elem = 1;
+  counting_resource upstream{};
+  {
+    loo::node_pool pool{ capacity, &upstream };
+    queue_t first{ pool };
+    queue_t second{ pool };
+
+    // each round fills 4 nodes per queue and reclaims all but the last one, the first round starts
+    // in the initial node, so the second round appends one more node per queue, after which all
+    // appended nodes must be taken from the pool
+    std::size_t allocated = 0;
+    for (std::size_t round = 0; round < 8; ++round) {
+      for (auto queue : { &first, &second }) {
+        for (std::size_t op = 0; op < 4 * 64; ++op) {
+          queue->enqueue(&elem);
+        }
+      }
+
+      for (auto queue : { &first, &second }) {
+        while (queue->dequeue() != nullptr) {}
+        if (const auto stats = queue->stats(); stats.nodes_allocated != stats.nodes_freed + 1) {
+          std::cerr << "node pool queue did not reclaim all nodes (" << stats.nodes_freed
+                    << " of " << stats.nodes_allocated << " freed)" << std::endl;
+          return false;
+        }
+      }
+
+      if (round <= 1) {
+        allocated = upstream.allocated.load();
+      } else if (upstream.allocated.load() != allocated) {
+        std::cerr << "node pool did not re-use reclaimed nodes (" << upstream.allocated.load()
+                  << " instead of " << allocated << " nodes allocated)" << std::endl;
+        return false;
+      }
+    }
+
+    // reclaiming more nodes than the pool can retain releases the excess to the upstream resource,
+    // only the head nodes of both queues remain in use
+    for (std::size_t op = 0; op < 4 * capacity * 64; ++op) {
+      first.enqueue(&elem);
+    }
+
+    while (first.dequeue() != nullptr) {}
+    if (const auto outstanding = upstream.outstanding.load(); outstanding > capacity + 2) {
+      std::cerr << "node pool retained " << outstanding - 2 << " nodes" << std::endl;
+      return false;
+    }
+
+    // both queues allocate from and return nodes to the pool concurrently
+    const std::size_t threads = 4;
+    const std::size_t count = 10'000;
+    const auto sum = transport(
+        threads, count,
+        [&](std::size_t thread, std::size_t) { (thread % 2 == 0 ? first : second).enqueue(&elem); },
+        [&] {
+          auto res = first.dequeue();
+          return value_of(res != nullptr ? res : second.dequeue());
+        }
+    );
+
+    if (sum != threads * count || first.dequeue() != nullptr || second.dequeue() != nullptr) {
+      std::cerr << "node pool queues lost elements" << std::endl;
+      return false;
+    }
+  }
+
+  // the pool releases all retained nodes once destroyed
+  if (const auto outstanding = upstream.outstanding.load(); outstanding != 0) {
+    std::cerr << outstanding << " nodes leaked by the node pool" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/** transports elements in batches through bulk operations, which span node boundaries */
+bool test_bulk() {
+  const std::size_t threads = 4;
+  const std::size_t count = 10'000;
+  const std::size_t bulk_size = 64;
+  std::vector<std::size_t> elements(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    elements[i] = i;
+  }
+
+  std::vector<std::size_t*> batch(3 * 100);
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    batch[i] = &elements[i];
+  }
+
+  // a batch larger than a node is inserted (and retrieved) in order across several nodes
+  loo::queue<std::size_t, 64> queue{};
+  queue.enqueue_bulk(batch.begin(), batch.end());
+  std::vector<std::size_t*> out(batch.size() + 1);
+  if (
+      queue.dequeue_bulk(out.begin(), 100) != 100
+      || queue.dequeue_bulk(out.begin() + 100, out.size()) != batch.size() - 100
+      || !std::equal(batch.begin(), batch.end(), out.begin())
+  ) {
+    std::cerr << "bulk operations reordered or lost elements" << std::endl;
+    return false;
+  }
+
+  // bulk producers and consumers compete w/ each other
+  std::atomic_uint64_t sum{ 0 };
+  std::vector<std::thread> workers{};
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    workers.emplace_back([&] {
+      std::vector<std::size_t*> batch{};
+      for (std::size_t op = 0; op < count; ++op) {
+        batch.push_back(&elements[op]);
+        if (batch.size() == bulk_size || op == count - 1) {
+          queue.enqueue_bulk(batch.begin(), batch.end());
+          batch.clear();
+        }
+      }
+    });
+
+    workers.emplace_back([&] {
+      std::uint64_t thread_sum = 0;
+      std::vector<std::size_t*> batch(bulk_size);
+      for (std::size_t op = 0; op < count;) {
+        const auto n = queue.dequeue_bulk(batch.begin(), std::min(bulk_size, count - op));
+        for (std::size_t i = 0; i < n; ++i) {
+          thread_sum += *batch[i];
+        }
+
+        op += n;
+      }
+
+      sum.fetch_add(thread_sum);
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  if (queue.dequeue() != nullptr) {
+    std::cerr << "queue not empty after bulk transport" << std::endl;
+    return false;
+  }
+
+  if (const auto expected = threads * (count * (count - 1) / 2); sum.load() != expected) {
+    std::cerr << "bulk transport sum " << sum.load() << " instead of " << expected << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/** fills a bounded queue until `try_enqueue` fails and checks the number of inserted elements */
+bool test_bounded() {
+  const std::size_t capacity = 4096;
+  std::size_t elem = 0;
+  loo::queue<std::size_t> queue{ loo::queue_options{ .capacity = capacity } };
+
+  for (auto round = 0; round < 4; ++round) {
+    std::size_t inserted = 0;
+    while (queue.try_enqueue(&elem)) {
+      inserted += 1;
+    }
+
+    // the capacity is enforced at node granularity, so up to one additional node may be filled
+    if (inserted < capacity || inserted > capacity + 1024) {
+      std::cerr << "bounded queue accepted " << inserted << " elements" << std::endl;
+      return false;
+    }
+
+    // draining the queue must allow reclaiming (all but one) nodes, so it can be filled again
+    while (queue.dequeue() != nullptr) {}
+  }
+
+  return true;
+}
+
+/** checks that parked consumers are woken up by producers and that timed waits expire */
+bool test_blocking() {
+  // queues w/o the blocking policy have no waiter state at all
+  static_assert(sizeof(loo::queue<int>) < sizeof(loo::queue<int, 1024, loo::blocking>));
+
+  const std::size_t threads = 4;
+  const std::size_t count = 1000;
+  std::size_t elem = 0;
+  loo::queue<std::size_t, 1024, loo::blocking> queue{};
+
+  if (queue.wait_dequeue_for(std::chrono::milliseconds{ 10 }) != nullptr) {
+    std::cerr << "timed wait on empty queue returned an element" << std::endl;
+    return false;
+  }
+
+  std::atomic_size_t consumed{ 0 };
+  std::vector<std::thread> consumers{};
+  std::vector<std::thread> producers{};
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    consumers.emplace_back([&] {
+      for (std::size_t op = 0; op < count; ++op) {
+        queue.wait_dequeue();
+        consumed.fetch_add(1);
+      }
+    });
+
+    // producers pause periodically, so consumers are parked in between
+    producers.emplace_back([&] {
+      for (std::size_t op = 0; op < count; ++op) {
+        if (op % 100 == 0) {
+          std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+
+        queue.enqueue(&elem);
+      }
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  // consumers still parked long after all elements were enqueued have missed a wake-up, so they are
+  // released by enqueuing the missing elements before reporting the failure
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+  while (consumed.load() < threads * count && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+  }
+
+  bool lost_wake_up = false;
+  if (const auto missing = threads * count - consumed.load(); missing != 0) {
+    std::cerr << "blocked consumers missed a wake-up (" << missing << " elements not dequeued)"
+              << std::endl;
+    lost_wake_up = true;
+    for (std::size_t op = 0; op < missing; ++op) {
+      queue.enqueue(&elem);
+    }
+  }
+
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  if (lost_wake_up) {
+    return false;
+  }
+
+  if (queue.dequeue() != nullptr) {
+    std::cerr << "blocking queue not empty after all elements were dequeued" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * round-trips (zero) values through a value queue (w/ small nodes) in order and checks the
+ * encodable range
+ */
+bool test_values() {
+  const std::size_t threads = 4;
+  const std::size_t count = 10'000;
+  loo::value_queue<std::uint64_t, 64, loo::blocking> queue{};
+
+  try {
+    queue.enqueue(std::uint64_t{ 1 } << 62);
+    std::cerr << "value queue accepted a 63-bit value" << std::endl;
+    return false;
+  } catch (const std::invalid_argument&) {}
+
+  const std::uint64_t values[] = { 0, 1, (std::uint64_t{ 1 } << 62) - 2 };
+  queue.enqueue_bulk(std::begin(values), std::end(values));
+  for (const auto value : values) {
+    if (queue.dequeue() != value) {
+      std::cerr << "value queue did not return " << value << std::endl;
+      return false;
+    }
+  }
+
+  // values are encoded into the slots themselves, so each one must survive across node boundaries
+  for (std::uint64_t value = 0; value < 4 * 64; ++value) {
+    queue.enqueue(value * value);
+  }
+
+  for (std::uint64_t value = 0; value < 4 * 64; ++value) {
+    if (const auto res = queue.dequeue(); res != value * value) {
+      std::cerr << "value queue returned " << res.value_or(~0ull) << " instead of "
+                << value * value << std::endl;
+      return false;
+    }
+  }
+
+  const auto sum = transport(
+      threads, count,
+      [&](std::size_t, std::uint64_t op) { queue.enqueue(op); },
+      [&] { return std::optional{ queue.wait_dequeue() }; }
+  );
+
+  return !queue.dequeue().has_value() && sum == threads * (count * (count - 1) / 2);
+}
+
+/**
+ * checks the composition of (pointer, index) pairs in the high pointer bits and transports
+ * elements through a queue w/ more threads than low-bit tagging would permit for its node size
+ */
+bool test_high_bit_tagging() {
+  using marked_ptr_t = loo::detail::native_marked_ptr_t<std::size_t, 16>;
+  using queue_t = loo::queue<std::size_t, 4, loo::high_bit_tagging<>>;
+  static_assert(queue_t::MAX_PRODUCER_THREADS == (1u << 16) - 4 + 1);
+
+  const std::size_t threads = 8;
+  const std::size_t count = 2'500;
+  static_assert(loo::queue<std::size_t, 4>::MAX_CONSUMER_THREADS < threads);
+
+  // the index occupies exactly the 16 high bits and wraps around without touching the pointer
+  std::size_t elem = 0;
+  marked_ptr_t marked{ &elem, 0xFFFF };
+  if (
+      !marked_ptr_t::is_valid(&elem) || marked.decompose_ptr() != &elem
+      || marked.decompose_tag() != 0xFFFF
+  ) {
+    std::cerr << "high bit tag did not round-trip" << std::endl;
+    return false;
+  }
+
+  marked.inc_idx();
+  if (marked.decompose_ptr() != &elem || marked.decompose_tag() != 0) {
+    std::cerr << "high bit tag overflowed into the pointer" << std::endl;
+    return false;
+  }
+
+  const auto invalid = reinterpret_cast<std::size_t*>(std::uintptr_t{ 1 } << 63);
+  if (marked_ptr_t::is_valid(invalid)) {
+    std::cerr << "pointer w/ high bits set accepted as valid" << std::endl;
+    return false;
+  }
+
+  std::vector<std::size_t> elements(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    elements[i] = i;
+  }
+
+  queue_t queue{};
+  const auto sum = transport(
+      threads, count,
+      [&](std::size_t, std::size_t op) { queue.enqueue(&elements[op]); },
+      [&] { return value_of(queue.dequeue()); }
+  );
+
+  return queue.dequeue() == nullptr && sum == threads * (count * (count - 1) / 2);
+}
+
+/** checks the node and slow path counters of a queue w/ enabled stats */
+bool test_stats() {
+  // disabled stats must not occupy any space
+  static_assert(sizeof(loo::queue<int>) == sizeof(loo::queue<int, 1024, loo::no_stats>));
+
+  const std::size_t count = 4 * 1024;
+  std::size_t elem = 0;
+  loo::queue<std::size_t, 1024, loo::sharded_stats<>> queue{};
+  for (std::size_t op = 0; op < count; ++op) {
+    queue.enqueue(&elem);
+  }
+
+  while (queue.dequeue() != nullptr) {}
+
+  // 3 nodes have been appended and all but the current head node have been reclaimed
+  const auto stats = queue.stats();
+  if (
+      stats.enqueue_slow_paths != 3 || stats.nodes_allocated != 4 || stats.nodes_freed != 3
+      || stats.failed_appends != 0 || stats.abandoned_slots != 0
+  ) {
+    std::cerr << "unexpected stats: " << stats.enqueue_slow_paths << " enqueue slow paths, "
+              << stats.nodes_allocated << " allocated, " << stats.nodes_freed << " freed"
+              << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * checks that producers enqueue to their local shard and that consumers steal from remote shards of
+ * a NUMA queue w/ (emulated) nodes
+ */
+bool test_numa() {
+  const std::size_t threads = 4;
+  const std::size_t count = 10'000;
+  std::size_t elem = 1;
+  loo::numa_queue<std::size_t> queue{ loo::numa_topology::emulate(2) };
+
+  // the thread may migrate to another node in between, in which case the check is repeated
+  for (std::size_t attempt = 0;; ++attempt) {
+    const auto local = queue.local_shard_idx();
+    queue.enqueue(&elem);
+    if (queue.shard(local).dequeue() == &elem) {
+      break;
+    }
+
+    if (queue.dequeue() != &elem || attempt == 100) {
+      std::cerr << "numa queue did not enqueue to local shard " << local << std::endl;
+      return false;
+    }
+  }
+
+  // the remote shard is not necessarily shard 1, if the CPUs are divided among both shards
+  const auto remote = (queue.local_shard_idx() + 1) % queue.shards();
+  queue.shard(remote).enqueue(&elem);
+  if (queue.dequeue() != &elem || queue.dequeue() != nullptr) {
+    std::cerr << "numa queue did not steal from remote shard" << std::endl;
+    return false;
+  }
+
+  const auto sum = transport(
+      threads, count,
+      [&](std::size_t, std::size_t) { queue.enqueue(&elem); },
+      [&] { return value_of(queue.dequeue()); }
+  );
+
+  return queue.dequeue() == nullptr && sum == threads * count;
+}
+
+/**
+ * checks that a multi queue falls back to other shards, that each thread sticks to its shards per
+ * multi queue and that no elements are lost
+ */
+bool test_multi_queue() {
+  const std::size_t threads = 4;
+  const std::size_t count = 10'000;
+  std::size_t elem = 1;
+  loo::multi_queue<std::size_t> queue{ loo::multi_queue_options{
+      .shards = 4, .choice = loo::multi_queue_choice::TWO_CHOICE
+  } };
+
+  // a dequeue must only fail if all shards are empty
+  for (std::size_t shard = 0; shard < queue.shards(); ++shard) {
+    queue.shard(shard).enqueue(&elem);
+    if (queue.dequeue() != &elem || queue.dequeue() != nullptr) {
+      std::cerr << "multi queue did not fall back to shard " << shard << std::endl;
+      return false;
+    }
+  }
+
+  // a thread alternating between two multi queues enqueues all elements of each to a single shard
+  const auto options = loo::multi_queue_options{ .shards = 16, .stickiness = 8 };
+  loo::multi_queue<std::size_t> first{ options };
+  loo::multi_queue<std::size_t> second{ options };
+  for (std::size_t op = 0; op < options.stickiness; ++op) {
+    first.enqueue(&elem);
+    second.enqueue(&elem);
+  }
+
+  for (auto multi : { &first, &second }) {
+    for (std::size_t shard = 0; shard < multi->shards(); ++shard) {
+      std::size_t elems = 0;
+      while (multi->shard(shard).dequeue() != nullptr) {
+        ++elems;
+      }
+
+      if (elems != 0 && elems != options.stickiness) {
+        std::cerr << "multi queue shard " << shard << " received " << elems << " of "
+                  << options.stickiness << " sticky elements" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  const auto sum = transport(
+      threads, count,
+      [&](std::size_t, std::size_t) { queue.enqueue(&elem); },
+      [&] { return value_of(queue.dequeue()); }
+  );
+
+  return queue.dequeue() == nullptr && sum == threads * count;
+}
+
+/** fills and drains a queue allocating its nodes from a huge page arena (through a node pool) */
+bool test_huge_page_arena() {
+  const std::size_t count = 256 * 1024;
+  std::size_t elem = 0;
+  loo::huge_page_arena arena{};
+  loo::node_pool pool{ 0, &arena };
+  loo::queue<std::size_t> queue{ pool };
+
+  for (std::size_t round = 0; round < 2; ++round) {
+    for (std::size_t op = 0; op < count; ++op) {
+      queue.enqueue(&elem);
+    }
+
+    for (std::size_t op = 0; op < count; ++op) {
+      if (queue.dequeue() != &elem) {
+        std::cerr << "huge page arena queue lost an element" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  // all nodes of the second round must have been recycled from the first round
+  const auto chunks = arena.chunks();
+  for (std::size_t op = 0; op < count; ++op) {
+    queue.enqueue(&elem);
+  }
+
+  if (arena.backing() == loo::huge_page_backing::NONE || arena.chunks() != chunks) {
+    std::cerr << "huge page arena did not recycle nodes (" << chunks << " chunks)" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * runs `producers` and `consumers` threads on a queue w/ the given policies, checks that the
+ * elements of each producer are dequeued in order and all but the current node are reclaimed
+ */
+template <typename... Policies>
+bool test_policies(std::size_t producers, std::size_t consumers) {
+  using queue_t = loo::value_queue<std::uint64_t, 64, loo::sharded_stats<>, Policies...>;
+  const std::uint64_t count = 50'000;
+  const std::size_t bulk_size = 16;
+  queue_t queue{};
+
+  std::atomic_bool failed{ false };
+  std::atomic_uint64_t dequeued{ 0 };
+  std::vector<std::thread> workers{};
+  for (std::size_t thread = 0; thread < producers; ++thread) {
+    // every other producer inserts its elements in bulk, elements encode (producer, sequence)
+    workers.emplace_back([&, thread, bulk = thread % 2 == 1] {
+      std::vector<std::uint64_t> batch{};
+      for (std::uint64_t op = 1; op <= count; ++op) {
+        const auto elem = (std::uint64_t(thread) << 32) | op;
+        if (!bulk) {
+          queue.enqueue(elem);
+          continue;
+        }
+
+        batch.push_back(elem);
+        if (batch.size() == bulk_size || op == count) {
+          queue.enqueue_bulk(std::span<const std::uint64_t>(batch));
+          batch.clear();
+        }
+      }
+    });
+  }
+
+  for (std::size_t thread = 0; thread < consumers; ++thread) {
+    workers.emplace_back([&, bulk = thread % 2 == 1] {
+      std::vector<std::uint64_t> last(producers, 0);
+      std::vector<std::uint64_t> batch(bulk_size);
+      auto consume = [&](std::uint64_t elem) {
+        auto& prev = last[elem >> 32];
+        if ((elem & 0xFFFF'FFFF) <= prev) {
+          failed.store(true);
+        }
+
+        prev = elem & 0xFFFF'FFFF;
+        dequeued.fetch_add(1, std::memory_order_relaxed);
+      };
+
+      while (dequeued.load(std::memory_order_relaxed) < producers * count) {
+        if (bulk) {
+          const auto n = queue.dequeue_bulk(std::span<std::uint64_t>(batch));
+          std::for_each(batch.begin(), batch.begin() + n, consume);
+        } else if (const auto res = queue.dequeue(); res) {
+          consume(*res);
+        }
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  // a spare node may have been prepared in addition to the current node
+  const auto stats = queue.stats();
+  const auto retained = 1 + (queue_t::SPARE_WATERMARK < 64 ? 1 : 0);
+  if (failed.load() || queue.dequeue() || stats.nodes_allocated > stats.nodes_freed + retained) {
+    std::cerr << "policy test failed for " << producers << " producers, " << consumers
+              << " consumers (" << stats.nodes_allocated << " allocated, " << stats.nodes_freed
+              << " freed)" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/** checks the single producer/consumer variants (the same thread may both enqueue and dequeue) */
+bool test_single_roles() {
+  static_assert(loo::queue<int, 64, loo::single_producer>::MAX_PRODUCER_THREADS == 1);
+  static_assert(loo::queue<int, 64, loo::single_consumer>::MAX_CONSUMER_THREADS == 1);
+
+  // a bounded SPSC queue
+  std::size_t elem = 0;
+  loo::queue<std::size_t, 64, loo::single_producer, loo::single_consumer> bounded{
+      loo::queue_options{ .capacity = 256 }
+  };
+
+  std::size_t inserted = 0;
+  for (; bounded.try_enqueue(&elem); ++inserted) {}
+  while (bounded.dequeue() != nullptr) {
+    --inserted;
+  }
+
+  if (inserted != 0 || !bounded.try_enqueue(&elem) || bounded.dequeue() != &elem) {
+    std::cerr << "bounded SPSC queue failed" << std::endl;
+    return false;
+  }
+
+  return test_policies<loo::single_producer, loo::single_consumer>(1, 1)
+      && test_policies<loo::single_producer>(1, 4)
+      && test_policies<loo::single_consumer>(4, 1);
+}
+
+/** checks that spare nodes are prepared ahead of time and used for appending */
+bool test_spare_node() {
+  using queue_t = loo::queue<std::size_t, 64, loo::spare_node<>, loo::sharded_stats<>>;
+  static_assert(queue_t::SPARE_WATERMARK == 32);
+
+  std::size_t elem = 0;
+  {
+    queue_t queue{};
+    for (std::size_t op = 0; op < 4 * 64; ++op) {
+      queue.enqueue(&elem);
+    }
+
+    // 3 nodes have been appended, each of which as well as the initial node prepared a spare node
+    auto stats = queue.stats();
+    if (stats.nodes_allocated != 5 || stats.enqueue_slow_paths != 3) {
+      std::cerr << "unexpected number of spare nodes (" << stats.nodes_allocated << ")" << std::endl;
+      return false;
+    }
+
+    while (queue.dequeue() != nullptr) {}
+    if (const auto freed = queue.stats().nodes_freed; freed != 3) {
+      std::cerr << "unexpected number of freed nodes (" << freed << ")" << std::endl;
+      return false;
+    }
+  }
+
+  return test_policies<loo::spare_node<>>(4, 4)
+      && test_policies<loo::spare_node<0>, loo::single_producer>(1, 2);
+}
+
+/** checks the spin limits of all wait policies and transports elements through queues using them */
+bool test_wait_policies() {
+  // a slot that is never written is abandoned after the configured number of spins
+  std::size_t spins = 0;
+  const auto never = [&spins] { return ++spins, false; };
+  if (loo::no_wait::wait(never) || loo::spin_wait<16>::wait(never) || spins != 16) {
+    std::cerr << "unexpected number of spins (" << spins << ")" << std::endl;
+    return false;
+  }
+
+  // adaptive waiting spins longer after slots have (eventually) been written
+  spins = 0;
+  loo::adaptive_wait<64>::wait(never);
+  const auto before = spins;
+  for (std::size_t i = 0; i < 16; ++i) {
+    std::size_t attempts = 0;
+    if (!loo::adaptive_wait<64>::wait([&attempts] { return ++attempts == 16; })) {
+      std::cerr << "adaptive wait gave up too soon" << std::endl;
+      return false;
+    }
+  }
+
+  spins = 0;
+  loo::adaptive_wait<64>::wait(never);
+  if (spins <= before || spins > 64) {
+    std::cerr << "adaptive wait did not adapt (" << before << " -> " << spins << ")" << std::endl;
+    return false;
+  }
+
+  return test_policies<loo::spin_wait<>>(4, 4)
+      && test_policies<loo::adaptive_wait<>>(4, 4)
+      && test_policies<loo::adaptive_wait<>, loo::single_consumer>(4, 1);
+}
+
+/**
+ * checks that elements are dequeued in the order of their lanes and that no element is lost, while
+ * lanes are concurrently drained and refilled
+ */
+bool test_priority_queue() {
+  const std::size_t threads = 4;
+  const std::size_t count = 10'000;
+  std::size_t elems[4] = { 1, 2, 3, 4 };
+  loo::priority_queue<std::size_t, 4> queue{};
+
+  // elements are dequeued in the order of their lanes, the bits of drained lanes are cleared
+  queue.enqueue(3, &elems[3]);
+  queue.enqueue(1, &elems[1]);
+  queue.enqueue(1, &elems[1]);
+  queue.enqueue(0, &elems[0]);
+  if (queue.summary() != 0b1011) {
+    std::cerr << "unexpected summary (" << queue.summary() << ")" << std::endl;
+    return false;
+  }
+
+  for (const auto expected : { &elems[0], &elems[1], &elems[1], &elems[3] }) {
+    if (queue.dequeue() != expected) {
+      std::cerr << "priority queue dequeued out of priority order" << std::endl;
+      return false;
+    }
+  }
+
+  if (queue.dequeue() != nullptr || queue.summary() != 0) {
+    std::cerr << "empty lanes were not cleared (" << queue.summary() << ")" << std::endl;
+    return false;
+  }
+
+  const auto sum = transport(
+      threads, count,
+      [&](std::size_t thread, std::size_t op) {
+        const auto lane = (op * 7 + thread) % 4;
+        queue.enqueue(lane, &elems[lane]);
+      },
+      [&] { return value_of(queue.dequeue()); }
+  );
+
+  // each thread enqueues each lane's element count / 4 times
+  return queue.dequeue() == nullptr && sum == threads * count / 4 * (1 + 2 + 3 + 4);
+}
+
+/** deletes elements and counts all deleted elements */
+struct counting_deleter {
+  static inline std::size_t deleted = 0;
+
+  void operator()(std::size_t* elem) const {
+    delete elem;
+    ++deleted;
+  }
+};
+
+/** checks the FIFO order of `consume_all` and `drain` across nodes and the deleter's leftovers */
+bool test_consume_all() {
+  const std::size_t count = 3 * 64 + 10;
+  std::vector<std::size_t> elems(count);
+  {
+    loo::queue<std::size_t, 64, loo::sharded_stats<>> queue{};
+    for (std::size_t i = 0; i < count; ++i) {
+      elems[i] = i;
+      queue.enqueue(&elems[i]);
+    }
+
+    // all elements are visited in order, the fully consumed nodes are reclaimed
+    std::size_t next = 0;
+    const auto consumed = queue.consume_all([&next](std::size_t* elem) {
+      next += *elem == next ? 1 : count;
+    });
+
+    if (consumed != count || next != count || queue.dequeue() != nullptr) {
+      std::cerr << "consume_all failed (" << consumed << " consumed)" << std::endl;
+      return false;
+    }
+
+    if (const auto stats = queue.stats(); stats.nodes_freed != 3 || stats.abandoned_slots != 0) {
+      std::cerr << "consume_all did not reclaim all nodes (" << stats.nodes_freed << ")"
+                << std::endl;
+      return false;
+    }
+
+    // a partially consumed node is drained from the current head index
+    for (std::size_t i = 0; i < 100; ++i) {
+      queue.enqueue(&elems[i]);
+    }
+
+    queue.dequeue();
+    std::vector<std::size_t*> drained{};
+    if (queue.drain(std::back_inserter(drained)) != 99 || drained.front() != &elems[1]) {
+      std::cerr << "drain failed" << std::endl;
+      return false;
+    }
+  }
+
+  // remaining elements are handed to the deleter upon destruction
+  {
+    loo::queue<std::size_t, 64, loo::deleter<counting_deleter>> queue{};
+    for (std::size_t i = 0; i < count; ++i) {
+      queue.enqueue(new std::size_t{ i });
+    }
+
+    delete queue.dequeue();
+  }
+
+  if (counting_deleter::deleted != count - 1) {
+    std::cerr << "deleted " << counting_deleter::deleted << " remaining elements" << std::endl;
+    return false;
+  }
+
+  // consume_all competes w/ regular dequeue operations
+  const std::size_t threads = 4;
+  const std::size_t ops = 10'000;
+  std::size_t elem = 1;
+  loo::queue<std::size_t, 64> queue{};
+  std::atomic_uint64_t sum{ 0 };
+  std::vector<std::thread> workers{};
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    workers.emplace_back([&] {
+      for (std::size_t op = 0; op < ops; ++op) {
+        queue.enqueue(&elem);
+      }
+    });
+
+    // consumers may take any share of all elements, so they stop once all have been consumed
+    workers.emplace_back([&, thread] {
+      while (sum.load() < threads * ops) {
+        if (thread % 2 == 0) {
+          queue.consume_all([&](std::size_t* res) { sum.fetch_add(*res); });
+        } else if (const auto res = queue.dequeue(); res != nullptr) {
+          sum.fetch_add(*res);
+        }
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  return sum.load() == threads * ops && queue.dequeue() == nullptr;
+}
+
+/** checks lazily allocated, growing (and shrinking) nodes and unpadded queues */
+bool test_low_footprint() {
+  using compact_t = loo::queue<
+      std::size_t, 1024, loo::high_bit_tagging<>, loo::sharded_stats<>, loo::growing_nodes<8>,
+      loo::no_padding
+  >;
+  using padded_t = loo::queue<std::size_t, 1024, loo::high_bit_tagging<>>;
+  using unpadded_t = loo::queue<std::size_t, 1024, loo::high_bit_tagging<>, loo::no_padding>;
+  static_assert(sizeof(unpadded_t) < sizeof(padded_t));
+
+  // idle compact queues retain no reclaimed (large) nodes in a pool by default
+  static_assert(compact_t::DEFAULT_POOL_CAPACITY == 0 && padded_t::DEFAULT_POOL_CAPACITY != 0);
+
+  std::size_t elem = 0;
+  compact_t queue{};
+  if (queue.dequeue() != nullptr || queue.stats().nodes_allocated != 0) {
+    std::cerr << "compact queue allocated a node before the first enqueue" << std::endl;
+    return false;
+  }
+
+  // nodes of 8, 16, ..., 1024 slots are appended while the queue fills up
+  std::size_t count = 0;
+  for (std::size_t size = 8; size <= 1024; size *= 2) {
+    count += size;
+  }
+
+  for (std::size_t i = 0; i < count + 1; ++i) {
+    queue.enqueue(&elem);
+  }
+
+  if (queue.stats().nodes_allocated != 9) {
+    std::cerr << "compact queue allocated " << queue.stats().nodes_allocated << " nodes, expected 9"
+              << std::endl;
+    return false;
+  }
+
+  // once the queue has been drained, a small node is appended after the current (large) one
+  for (std::size_t i = 0; i < count + 1; ++i) {
+    if (queue.dequeue() != &elem) {
+      std::cerr << "compact queue lost an element" << std::endl;
+      return false;
+    }
+  }
+
+  if (queue.dequeue() != nullptr) {
+    std::cerr << "compact queue not empty after all elements were dequeued" << std::endl;
+    return false;
+  }
+
+  // the remaining 1023 slots of the current node are filled before a node of 8 slots is appended
+  for (std::size_t i = 0; i < 1023 + 8; ++i) {
+    queue.enqueue(&elem);
+  }
+
+  const auto stats = queue.stats();
+  if (stats.nodes_allocated != 10 || stats.nodes_allocated - stats.nodes_freed != 2) {
+    std::cerr << "compact queue did not shrink (" << stats.nodes_allocated << " allocated, "
+              << stats.nodes_freed << " freed)" << std::endl;
+    return false;
+  }
+
+  // a bounded compact queue still holds (at least) its capacity, but may exceed it by one node more
+  // than a queue w/ fixed nodes
+  using bounded_t = loo::queue<std::size_t, 64, loo::growing_nodes<4>>;
+  bounded_t bounded{ loo::queue_options{ .capacity = 200 } };
+  std::size_t inserted = 0;
+  for (; bounded.try_enqueue(&elem); ++inserted) {}
+  if (inserted < 200 || inserted > 200 + 3 * 64) {
+    std::cerr << "bounded compact queue accepted " << inserted << " elements" << std::endl;
+    return false;
+  }
+
+  return test_policies<loo::growing_nodes<>, loo::no_padding>(4, 4)
+      && test_policies<loo::growing_nodes<4, false>, loo::single_producer>(1, 4)
+      && test_policies<loo::growing_nodes<>, loo::single_producer, loo::single_consumer>(1, 1);
+}
+
+/** polls (mostly) empty queues through read-only checks */
+bool test_polling() {
+  loo::value_queue<std::uint64_t, 64> queue{};
+  if (queue.try_dequeue() || queue.poll_dequeue_for(std::chrono::milliseconds{ 1 })) {
+    std::cerr << "polling an empty queue returned an element" << std::endl;
+    return false;
+  }
+
+  // elements are polled in order across node boundaries
+  for (std::uint64_t elem = 1; elem <= 100; ++elem) {
+    queue.enqueue(elem);
+  }
+
+  for (std::uint64_t elem = 1; elem <= 100; ++elem) {
+    if (queue.try_dequeue() != elem) {
+      std::cerr << "try_dequeue did not return " << elem << std::endl;
+      return false;
+    }
+  }
+
+  // many idle pollers compete for few elements, which producers enqueue in bursts
+  const std::size_t pollers = 8;
+  const std::size_t producers = 2;
+  const std::uint64_t count = 2'000;
+  std::atomic_uint64_t sum{ 0 };
+  std::atomic_uint64_t polled{ 0 };
+  std::vector<std::thread> workers{};
+  for (std::size_t thread = 0; thread < pollers; ++thread) {
+    workers.emplace_back([&] {
+      while (polled.load() < producers * count) {
+        if (const auto res = queue.poll_dequeue_for(std::chrono::milliseconds{ 1 }); res) {
+          sum.fetch_add(*res);
+          polled.fetch_add(1);
+        }
+      }
+    });
+  }
+
+  for (std::size_t thread = 0; thread < producers; ++thread) {
+    workers.emplace_back([&] {
+      for (std::uint64_t elem = 1; elem <= count; ++elem) {
+        if (elem % 500 == 0) {
+          std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+
+        queue.enqueue(elem);
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  return sum.load() == producers * count * (count + 1) / 2 && !queue.try_dequeue();
+}
+
+/** the state shared by all processes in `test_shm` (the segment's root object) */
+struct shm_shared_t {
+  std::uint64_t        queue{ 0 };
+  std::atomic_uint64_t dequeued{ 0 };
+  std::atomic_uint64_t sum{ 0 };
+  std::atomic_uint64_t errors{ 0 };
+};
+
+/**
+ * exchanges payloads allocated from a shared memory segment between forked processes, each of which
+ * maps the segment again (at another address) and reclaims nodes returned to the shared arena
+ */
+bool test_shm() {
+  using queue_t = loo::shm_queue<std::uint64_t, 64>;
+  const std::size_t producers = 2;
+  const std::size_t consumers = 2;
+  const std::uint64_t count = 20'000;
+  const auto name = "/loo-test-" + std::to_string(getpid());
+
+  // a segment too small for its arena is rejected and its name is released again
+  try {
+    loo::shm_segment::create(name, 64);
+    std::cerr << "undersized shm segment was created" << std::endl;
+    return false;
+  } catch (const std::bad_alloc&) {}
+
+  auto segment = loo::shm_segment::create(name, std::size_t{ 64 } << 20);
+  auto& arena = segment.arena();
+  const auto shared = arena.construct<shm_shared_t>();
+  shared->queue = arena.offset_of(arena.construct<queue_t>(arena));
+  arena.set_root(shared);
+
+  const auto run_child = [&](std::size_t id, bool producer) {
+    try {
+      // the inherited mapping is still in place, so the segment is mapped at another address
+      const auto child = loo::shm_segment::open(name);
+      auto& arena = child.arena();
+      const auto shared = arena.root<shm_shared_t>();
+      const auto queue = arena.at<queue_t>(shared->queue);
+
+      if (producer) {
+        for (std::uint64_t elem = 1; elem <= count; ++elem) {
+          queue->enqueue(arena.construct<std::uint64_t>(id * count + elem));
+        }
+      } else {
+        // elements of each producer must be dequeued in order
+        std::vector<std::uint64_t> last(producers, 0);
+        while (shared->dequeued.load() < producers * count) {
+          if (const auto elem = queue->dequeue(); elem != nullptr) {
+            const auto value = *elem;
+            auto& prev = last[(value - 1) / count];
+            shared->errors.fetch_add(value <= prev ? 1 : 0);
+            prev = value;
+            shared->sum.fetch_add(value);
+            shared->dequeued.fetch_add(1);
+            arena.destroy(elem);
+          }
+        }
+      }
+
+      _exit(0);
+    } catch (...) {
+      _exit(1);
+    }
+  };
+
+  std::vector<pid_t> children{};
+  for (std::size_t child = 0; child < producers + consumers; ++child) {
+    if (const auto pid = fork(); pid == 0) {
+      run_child(child, child < producers);
+    } else {
+      children.push_back(pid);
+    }
+  }
+
+  auto success = true;
+  for (const auto pid : children) {
+    int status = 0;
+    success &= waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+
+  const auto total = producers * count;
+  const auto queue = arena.at<queue_t>(shared->queue);
+  success &= shared->sum.load() == total * (total + 1) / 2 && shared->errors.load() == 0;
+  success &= queue->dequeue() == nullptr;
+
+  // all nodes reclaimed by any process and all payloads must have been returned to the arena
+  arena.destroy(queue);
+  arena.destroy(shared);
+  if (arena.allocated_bytes() != 0) {
+    std::cerr << "shared arena leaked " << arena.allocated_bytes() << " bytes" << std::endl;
+    success = false;
+  }
+
+  // blocks of more distinct sizes than there are size classes are rejected instead of leaked, all
+  // others are re-used once de-allocated
+  std::vector<std::pair<void*, std::size_t>> blocks{};
+  try {
+    const auto step = CACHE_LINE_ALIGN;
+    for (std::size_t bytes = step; bytes <= 2 * step * loo::shm_arena::SIZE_CLASSES; bytes += step) {
+      blocks.emplace_back(arena.allocate(bytes), bytes);
+    }
+  } catch (const std::bad_alloc&) {}
+
+  for (const auto [block, bytes] : blocks) {
+    arena.deallocate(block, bytes);
+  }
+
+  if (blocks.size() > loo::shm_arena::SIZE_CLASSES) {
+    std::cerr << "shared arena allocated blocks of " << blocks.size() << " sizes" << std::endl;
+    success = false;
+  }
+
+  for (const auto [block, bytes] : blocks) {
+    if (const auto reused = arena.allocate(bytes); reused != block) {
+      std::cerr << "shared arena did not re-use a block of " << bytes << " bytes" << std::endl;
+      success = false;
+    } else {
+      arena.deallocate(reused, bytes);
+    }
+  }
+
+  loo::shm_segment::unlink(name);
+  if (!success) {
+    std::cerr << "shared memory queue lost or reordered elements" << std::endl;
+  }
+
+  return success;
+}
+
+/** spawns a binary tree of tasks of the given depth, each of which increments `count` */
+void spawn_tree(loo::executor& executor, std::size_t depth, std::atomic_uint64_t& count) {
+  count.fetch_add(1, std::memory_order_relaxed);
+  if (depth == 0) {
+    return;
+  }
+
+  for (auto child = 0; child < 2; ++child) {
+    executor.submit([&executor, depth, &count] { spawn_tree(executor, depth - 1, count); });
+  }
+}
+
+/** runs nested, injected and overflowing tasks on a work-stealing executor */
+bool test_executor() {
+  const std::size_t depth = 12;
+  const std::size_t injected = 1'000;
+  const std::size_t fan_out = 10'000;
+  std::atomic_uint64_t tree{ 0 };
+  std::atomic_uint64_t tasks{ 0 };
+  std::atomic_uint64_t spawned{ 0 };
+
+  {
+    loo::executor executor{ 4 };
+    // a binary tree of tasks spawned by the workers themselves (waited for w/o blocking a worker)
+    executor.submit([&] { spawn_tree(executor, depth, tree); });
+    while (tree.load() < (std::uint64_t{ 2 } << depth) - 1) {
+      std::this_thread::yield();
+    }
+
+    // tasks injected by another thread, each of which spawns further tasks
+    for (std::size_t task = 0; task < injected; ++task) {
+      executor.submit([&] {
+        tasks.fetch_add(1);
+        executor.submit([&] { tasks.fetch_add(1); });
+      });
+    }
+
+    // a single task spawning more tasks than fit into its worker's deque
+    executor.submit([&] {
+      for (std::size_t task = 0; task < fan_out; ++task) {
+        executor.submit([&] { spawned.fetch_add(1); });
+      }
+    });
+
+    // the destructor runs all remaining tasks (including those submitted by them)
+  }
+
+  if (tasks.load() != 2 * injected || spawned.load() != fan_out) {
+    std::cerr << "executor ran " << tasks.load() << " injected and " << spawned.load()
+              << " fanned out tasks" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/** a single-threaded executor, which resumes all scheduled coroutines in order */
+struct inline_executor {
+  std::deque<std::coroutine_handle<>> ready{};
+
+  void execute(std::coroutine_handle<> handle) {
+    this->ready.push_back(handle);
+  }
+
+  void run() {
+    while (!this->ready.empty()) {
+      const auto handle = this->ready.front();
+      this->ready.pop_front();
+      handle.resume();
+    }
+  }
+};
+
+/** a coroutine, which starts eagerly and destroys itself once it completes */
+struct detached_task {
+  struct promise_type {
+    detached_task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+/** a value queue supporting `async_dequeue` */
+using async_queue_t = loo::value_queue<std::uint64_t, loo::DEFAULT_NODE_SIZE, loo::blocking>;
+
+/** dequeues `count` elements through `async_dequeue` and adds them to `sum` */
+detached_task consume_async(
+    async_queue_t& queue,
+    inline_executor& executor,
+    std::size_t count,
+    std::uint64_t& sum,
+    std::size_t& done
+) {
+  for (std::size_t op = 0; op < count; ++op) {
+    sum += co_await queue.async_dequeue(executor);
+  }
+
+  ++done;
+}
+
+/** resumes many coroutines suspended in `async_dequeue` on a single thread */
+bool test_async_dequeue() {
+  const std::size_t coroutines = 100;
+  const std::size_t count = 10;
+  std::uint64_t sum = 0;
+  std::size_t done = 0;
+  inline_executor executor{};
+  async_queue_t queue{};
+
+  // available elements are dequeued without suspending
+  queue.enqueue(1);
+  consume_async(queue, executor, 1, sum, done);
+  if (done != 1 || sum != 1 || !executor.ready.empty()) {
+    std::cerr << "async dequeue suspended despite an available element" << std::endl;
+    return false;
+  }
+
+  // all coroutines are suspended on the empty queue and resumed by subsequent enqueue operations,
+  // each of which resumes exactly one coroutine
+  sum = 0;
+  done = 0;
+  for (std::size_t i = 0; i < coroutines; ++i) {
+    consume_async(queue, executor, count, sum, done);
+  }
+
+  for (std::uint64_t elem = 1; elem <= coroutines * count; ++elem) {
+    queue.enqueue(elem);
+    if (executor.ready.size() != 1) {
+      std::cerr << "enqueue scheduled " << executor.ready.size() << " coroutines" << std::endl;
+      return false;
+    }
+
+    executor.run();
+  }
+
+  const auto expected = coroutines * count * (coroutines * count + 1) / 2;
+  return done == coroutines && sum == expected && !queue.dequeue();
+}
 
 int main() {
+  if (
+      !test_node_pool() || !test_bulk() || !test_bounded() || !test_blocking() || !test_values()
+      || !test_high_bit_tagging() || !test_stats() || !test_numa() || !test_multi_queue()
+      || !test_single_roles() || !test_huge_page_arena() || !test_spare_node() || !test_async_dequeue()
+      || !test_wait_policies() || !test_priority_queue() || !test_consume_all()
+      || !test_low_footprint() || !test_polling() || !test_shm() || !test_executor()
+  ) {
+    return 1;
+  }
+
   const std::size_t thread_count = 128;
   const std::size_t count = 100'000;
 